@@ -32,6 +32,9 @@ namespace MDP
     /*The following explicit state space algorithms are available:*/
     class PolicyIteration;
     class ValueIteration;
+    class CompressedPolicyIteration;
+    class CompressedValueIteration;
+    class IncrementalValueIteration;
     template<class ExplicitAlgorithm> class LAO;
 }
 
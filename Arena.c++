@@ -0,0 +1,503 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include"Arena.h++"
+
+#include<cstdlib>
+#include<sstream>
+
+const unsigned int Arena::granularity;
+const unsigned int Arena::smallBlock;
+const unsigned int Arena::coarseGranularity;
+const unsigned int Arena::mediumBlock;
+const unsigned int Arena::largestBlock;
+const unsigned int Arena::numberOfSizeClasses;
+const unsigned int Arena::chunkSize;
+const unsigned int Arena::chunkHeaderSize;
+
+__thread Arena* Arena::current = 0;
+__thread Arena::Cache* Arena::currentCache = 0;
+
+/*Chunks are registered in a map of two levels, with a bit for each
+  chunk sized part of the address space, so that the blocks of an
+  arena are told from those of the heap without locking. Leaves of
+  the map are made as they are needed, and are never freed.*/
+static const unsigned int chunkBits = 16;
+static const unsigned int leafBits = 16;
+static const unsigned int addressBits = 48;
+static const size_t numberOfLeaves = size_t(1) << (addressBits - chunkBits - leafBits);
+static const unsigned int wordBits = 8 * sizeof(unsigned long);
+
+static unsigned long* volatile chunkMap[numberOfLeaves];
+
+/*Guards the making of leaves.*/
+static pthread_mutex_t chunkMapMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*Mark the chunk at \argument{address} as \argument{mapped}. Returns
+  false if the address is beyond the map.*/
+static bool mapChunk(const void* address, bool mapped)
+{
+    size_t index = reinterpret_cast<size_t>(address) >> chunkBits;
+    size_t leafIndex = index >> leafBits;
+
+    if(leafIndex >= numberOfLeaves)
+        return false;
+
+    unsigned long* leaf = chunkMap[leafIndex];
+    if(0 == leaf)
+    {
+        pthread_mutex_lock(&chunkMapMutex);
+
+        leaf = chunkMap[leafIndex];
+        if(0 == leaf)
+        {
+            leaf = new unsigned long[(size_t(1) << leafBits) / wordBits]();
+
+            /*The leaf is cleared before it is published.*/
+            __sync_synchronize();
+            chunkMap[leafIndex] = leaf;
+        }
+
+        pthread_mutex_unlock(&chunkMapMutex);
+    }
+
+    size_t bit = index & ((size_t(1) << leafBits) - 1);
+    if(mapped)
+        __sync_fetch_and_or(&leaf[bit / wordBits], 1UL << (bit % wordBits));
+    else
+        __sync_fetch_and_and(&leaf[bit / wordBits], ~(1UL << (bit % wordBits)));
+
+    return true;
+}
+
+/*Is the chunk at \argument{address} mapped?*/
+static bool isMapped(const void* address)
+{
+    size_t index = reinterpret_cast<size_t>(address) >> chunkBits;
+    size_t leafIndex = index >> leafBits;
+
+    if(leafIndex >= numberOfLeaves)
+        return false;
+
+    const unsigned long* leaf = chunkMap[leafIndex];
+    size_t bit = index & ((size_t(1) << leafBits) - 1);
+
+    return 0 != leaf && 0 != (leaf[bit / wordBits] & (1UL << (bit % wordBits)));
+}
+
+        /*
+         *Construction
+         */
+
+Arena::Arena()
+    :chunks(0),
+     caches(0),
+     bytes(0),
+     blocks(0),
+     reservedBytes(0),
+     released(false)
+{
+    for(unsigned int sizeClass = 0; sizeClass < numberOfSizeClasses; ++sizeClass)
+        freeBlocks[sizeClass] = 0;
+
+    pthread_mutex_init(&mutex, 0);
+}
+
+Arena::~Arena()
+{
+    while(0 != chunks)
+    {
+        Chunk* chunk = chunks;
+        chunks = chunk->next;
+        freeChunk(chunk);
+    }
+
+    while(0 != caches)
+    {
+        Cache* cache = caches;
+        caches = cache->next;
+        delete cache;
+    }
+
+    pthread_mutex_destroy(&mutex);
+}
+
+        /*
+         *Functionality
+         */
+
+Arena* Arena::getCurrent()
+{
+    return current;
+}
+
+void* Arena::allocate(size_t bytes)
+{
+    Cache* cache = currentCache;
+
+    if(0 == cache)
+        return ::operator new(bytes);
+
+    void* block;
+
+    if(bytes > largestBlock)
+        block = current->allocateLarge(cache, bytes);
+    else
+    {
+        unsigned int sizeClass = sizeClassOf(bytes);
+        unsigned int size = sizeOf(sizeClass);
+
+        if(0 == cache->freeBlocks[sizeClass]
+           && size > static_cast<size_t>(cache->end[sizeClass] - cache->unused[sizeClass])
+           && !current->refill(cache, sizeClass))
+            return ::operator new(bytes);
+
+        if(0 != cache->freeBlocks[sizeClass])
+        {
+            block = cache->freeBlocks[sizeClass];
+            cache->freeBlocks[sizeClass] = cache->freeBlocks[sizeClass]->next;
+        }
+        else
+        {
+            block = cache->unused[sizeClass];
+            cache->unused[sizeClass] += size;
+        }
+
+        cache->bytes += size;
+        ++cache->blocks;
+        ++cache->allocations;
+    }
+
+    /*Where no chunk could be had the block is taken from the heap.*/
+    if(0 == block)
+        return ::operator new(bytes);
+
+    return block;
+}
+
+void Arena::deallocate(void* block)
+{
+    if(0 == block)
+        return;
+
+    Chunk* chunk = chunkOf(block);
+
+    if(0 == chunk)
+        ::operator delete(block);
+    else if(chunk->arena == current && numberOfSizeClasses != chunk->sizeClass)
+    {
+        Cache* cache = currentCache;
+
+        FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+        freeBlock->next = cache->freeBlocks[chunk->sizeClass];
+        cache->freeBlocks[chunk->sizeClass] = freeBlock;
+
+        cache->bytes -= sizeOf(chunk->sizeClass);
+        --cache->blocks;
+    }
+    else
+        chunk->arena->give(block, chunk);
+}
+
+void Arena::release()
+{
+    long long bytes;
+    long long blocks;
+    unsigned long long allocations;
+
+    pthread_mutex_lock(&mutex);
+    released = true;
+    total(bytes, blocks, allocations);
+    pthread_mutex_unlock(&mutex);
+
+    if(0 == blocks)
+        delete this;
+}
+
+unsigned int Arena::sizeClassOf(size_t bytes)
+{
+    if(0 == bytes)
+        bytes = 1;
+
+    if(bytes <= smallBlock)
+        return (bytes - 1) / granularity;
+
+    if(bytes <= mediumBlock)
+        return smallBlock / granularity + (bytes - smallBlock - 1) / coarseGranularity;
+
+    unsigned int sizeClass = smallBlock / granularity + (mediumBlock - smallBlock) / coarseGranularity;
+    for(size_t size = 2 * mediumBlock; size < bytes; size *= 2)
+        ++sizeClass;
+
+    return sizeClass;
+}
+
+unsigned int Arena::sizeOf(unsigned int sizeClass)
+{
+    const unsigned int smallClasses = smallBlock / granularity;
+    const unsigned int mediumClasses = smallClasses + (mediumBlock - smallBlock) / coarseGranularity;
+
+    if(sizeClass < smallClasses)
+        return (sizeClass + 1) * granularity;
+
+    if(sizeClass < mediumClasses)
+        return smallBlock + (sizeClass + 1 - smallClasses) * coarseGranularity;
+
+    return mediumBlock << (sizeClass + 1 - mediumClasses);
+}
+
+Arena::Chunk* Arena::chunkOf(void* block)
+{
+    char* chunk = static_cast<char*>(block) - reinterpret_cast<size_t>(block) % chunkSize;
+
+    return isMapped(chunk) ? reinterpret_cast<Chunk*>(chunk) : 0;
+}
+
+Arena::Cache* Arena::getCache()
+{
+    pthread_t thread = pthread_self();
+
+    pthread_mutex_lock(&mutex);
+
+    Cache* cache = caches;
+    while(0 != cache && !pthread_equal(cache->thread, thread))
+        cache = cache->next;
+
+    if(0 == cache)
+    {
+        cache = new Cache();
+        cache->thread = thread;
+        cache->next = caches;
+        caches = cache;
+    }
+
+    pthread_mutex_unlock(&mutex);
+
+    return cache;
+}
+
+bool Arena::refill(Cache* cache, unsigned int sizeClass)
+{
+    bool refilled = true;
+
+    pthread_mutex_lock(&mutex);
+
+    if(0 != freeBlocks[sizeClass])
+    {
+        /*The blocks returned to the arena are taken together.*/
+        cache->freeBlocks[sizeClass] = freeBlocks[sizeClass];
+        freeBlocks[sizeClass] = 0;
+    }
+    else
+    {
+        Chunk* chunk = takeChunk(chunkSize, sizeClass);
+
+        if(0 == chunk)
+            refilled = false;
+        else
+        {
+            chunk->next = chunks;
+            chunks = chunk;
+
+            /*Less than a block of the last chunk is abandoned.*/
+            cache->unused[sizeClass] = reinterpret_cast<char*>(chunk) + chunkHeaderSize;
+            cache->end[sizeClass] = reinterpret_cast<char*>(chunk) + chunkSize;
+        }
+    }
+
+    pthread_mutex_unlock(&mutex);
+
+    return refilled;
+}
+
+void* Arena::allocateLarge(Cache* cache, size_t bytes)
+{
+    size_t size = (chunkHeaderSize + bytes + chunkSize - 1) / chunkSize * chunkSize;
+
+    pthread_mutex_lock(&mutex);
+    Chunk* chunk = takeChunk(size, numberOfSizeClasses);
+    pthread_mutex_unlock(&mutex);
+
+    if(0 == chunk)
+        return 0;
+
+    cache->bytes += size;
+    ++cache->blocks;
+    ++cache->allocations;
+
+    return reinterpret_cast<char*>(chunk) + chunkHeaderSize;
+}
+
+void Arena::give(void* block, Chunk* chunk)
+{
+    long long bytes;
+    long long blocks;
+    unsigned long long allocations;
+
+    pthread_mutex_lock(&mutex);
+
+    if(numberOfSizeClasses == chunk->sizeClass)
+    {
+        this->bytes -= chunk->size;
+        reservedBytes -= chunk->size;
+        freeChunk(chunk);
+    }
+    else
+    {
+        FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+        freeBlock->next = freeBlocks[chunk->sizeClass];
+        freeBlocks[chunk->sizeClass] = freeBlock;
+
+        this->bytes -= sizeOf(chunk->sizeClass);
+    }
+    --this->blocks;
+
+    total(bytes, blocks, allocations);
+    bool unused = released && 0 == blocks;
+
+    pthread_mutex_unlock(&mutex);
+
+    if(unused)
+        delete this;
+}
+
+Arena::Chunk* Arena::takeChunk(size_t bytes, unsigned int sizeClass)
+{
+    void* memory;
+
+    if(0 != posix_memalign(&memory, chunkSize, bytes))
+        return 0;
+
+    if(!mapChunk(memory, true))
+    {
+        free(memory);
+        return 0;
+    }
+
+    Chunk* chunk = static_cast<Chunk*>(memory);
+    chunk->arena = this;
+    chunk->next = 0;
+    chunk->sizeClass = sizeClass;
+    chunk->size = bytes;
+
+    reservedBytes += bytes;
+
+    return chunk;
+}
+
+void Arena::freeChunk(Chunk* chunk)
+{
+    mapChunk(chunk, false);
+    free(chunk);
+}
+
+        /*
+         *Queries + Accessors
+         */
+
+void Arena::total(long long& bytes, long long& blocks, unsigned long long& allocations)const
+{
+    bytes = this->bytes;
+    blocks = this->blocks;
+    allocations = 0;
+
+    for(const Cache* cache = caches; 0 != cache; cache = cache->next)
+    {
+        bytes += cache->bytes;
+        blocks += cache->blocks;
+        allocations += cache->allocations;
+    }
+}
+
+unsigned long long Arena::getBytes()const
+{
+    long long bytes;
+    long long blocks;
+    unsigned long long allocations;
+
+    pthread_mutex_lock(&mutex);
+    total(bytes, blocks, allocations);
+    pthread_mutex_unlock(&mutex);
+
+    return bytes;
+}
+
+unsigned long long Arena::getReservedBytes()const
+{
+    pthread_mutex_lock(&mutex);
+    unsigned long long result = reservedBytes;
+    pthread_mutex_unlock(&mutex);
+
+    return result;
+}
+
+unsigned long long Arena::getBlocks()const
+{
+    long long bytes;
+    long long blocks;
+    unsigned long long allocations;
+
+    pthread_mutex_lock(&mutex);
+    total(bytes, blocks, allocations);
+    pthread_mutex_unlock(&mutex);
+
+    return blocks;
+}
+
+unsigned long long Arena::getAllocations()const
+{
+    long long bytes;
+    long long blocks;
+    unsigned long long allocations;
+
+    pthread_mutex_lock(&mutex);
+    total(bytes, blocks, allocations);
+    pthread_mutex_unlock(&mutex);
+
+    return allocations;
+}
+
+string Arena::report()const
+{
+    ostringstream result;
+
+    result<<"Blocks in use: "<<getBlocks()<<endl
+          <<"Bytes in use: "<<getBytes()<<endl
+          <<"Bytes reserved: "<<getReservedBytes()<<endl
+          <<"Allocations: "<<getAllocations()<<endl;
+
+    return result.str();
+}
+
+/*******************************************************ArenaScope*/
+
+ArenaScope::ArenaScope(Arena* arena)
+    :previous(Arena::current),
+     previousCache(Arena::currentCache)
+{
+    Arena::current = arena;
+
+    /*The cache is only looked up on entering another arena.*/
+    if(arena != previous)
+        Arena::currentCache = (0 == arena) ? 0 : arena->getCache();
+}
+
+ArenaScope::~ArenaScope()
+{
+    Arena::current = previous;
+    Arena::currentCache = previousCache;
+}
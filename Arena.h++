@@ -0,0 +1,302 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+/*
+ * \paragraph{:Purpose:}
+ *
+ * Pooled allocation of the many small objects of an expanded domain:
+ * the states, their transitions, their reward specifications and the
+ * formula nodes of those specifications.
+ *
+ * An \class{Arena} carves blocks of a few sizes out of large chunks.
+ * Every chunk holds blocks of one size only, and begins with a header
+ * naming its arena and size. Chunks are aligned on their size, thus
+ * the header of the chunk of a block is found from the address of the
+ * block and blocks carry no header of their own. Chunks are only
+ * returned to the heap when the arena is released, all at once. Every
+ * block is counted as it is allocated and freed, thus the bytes in use
+ * are known without visiting the objects. Storage those objects hold
+ * on the heap is not counted by the arena.
+ *
+ * Releasing an arena does not destroy its objects. Their owner still
+ * deletes each of them, which returns their blocks to the free lists
+ * of the arena rather than to the heap.
+ *
+ * Allocation is from the arena current in the calling thread (see
+ * \class{ArenaScope}). An \class{explicitDomainSpecification} makes
+ * its arena current while it expands or alters its states, and the
+ * \class{WorkerPool} tasks of an expansion make it current in the
+ * workers. Each thread allocates from a cache of its own in the
+ * arena, holding its freed blocks and the unused part of a chunk of
+ * each size, thus threads only synchronise to take a new chunk. A
+ * block freed by a thread in which its arena is not current is
+ * returned to the arena, under its lock. Objects allocated while no
+ * arena is current are taken from the heap.
+ * */
+
+#ifndef ARENA
+#define ARENA
+
+#include<cstddef>
+#include<string>
+#include<new>
+#include<pthread.h>
+
+using namespace std;
+
+class Arena
+{
+public:
+    /*Construction of an empty arena.*/
+    Arena();
+
+    /*The arena into which objects are allocated by the calling
+     *thread, $0$ if they are allocated on the heap.*/
+    static Arena* getCurrent();
+
+    /*Allocate \argument{bytes} from the current arena.*/
+    static void* allocate(size_t bytes);
+
+    /*Free a block obtained from \method{allocate()}. The block is
+     *returned to the arena it was allocated from.*/
+    static void deallocate(void*);
+
+    /*The owner of this arena is done with it. The chunks are freed
+     *when no block of this arena remains, which may be at once. The
+     *arena must not be current in any thread, and must not be used
+     *by the caller afterwards.*/
+    void release();
+
+    /*Number of bytes of the blocks of this arena that are in use. The
+     *counts are approximate while other threads allocate from the
+     *arena.*/
+    unsigned long long getBytes()const;
+
+    /*Number of bytes this arena has taken from the heap.*/
+    unsigned long long getReservedBytes()const;
+
+    /*Number of blocks of this arena that are in use.*/
+    unsigned long long getBlocks()const;
+
+    /*Number of blocks that have been allocated from this arena.*/
+    unsigned long long getAllocations()const;
+
+    /*The counts of this arena as text.*/
+    string report()const;
+private:
+    friend class ArenaScope;
+
+    /*Freeing is by \method{release()}.*/
+    ~Arena();
+
+    /*Blocks of up to \member{smallBlock} bytes are multiples of
+     *\member{granularity} bytes, those of up to \member{mediumBlock}
+     *bytes are multiples of \member{coarseGranularity} bytes, and
+     *those of up to \member{largestBlock} bytes are powers of
+     *two. Blocks larger than \member{largestBlock} have a chunk of
+     *their own, of a whole number of \member{chunkSize}s.*/
+    static const unsigned int granularity = 8;
+    static const unsigned int smallBlock = 128;
+    static const unsigned int coarseGranularity = 64;
+    static const unsigned int mediumBlock = 1024;
+    static const unsigned int largestBlock = 16 * mediumBlock;
+    static const unsigned int numberOfSizeClasses
+    = smallBlock / granularity + (mediumBlock - smallBlock) / coarseGranularity + 4;
+
+    /*Number of bytes of a chunk, and its alignment.*/
+    static const unsigned int chunkSize = 1 << 16;
+
+    /*Header at the start of each chunk. The \member{sizeClass} of
+     *the chunk of a single large block is
+     *\member{numberOfSizeClasses}.*/
+    struct Chunk
+    {
+        Arena* arena;
+        Chunk* next;
+        unsigned int sizeClass;
+        size_t size;
+    };
+
+    /*Bytes before the first block of a chunk, keeping the blocks
+     *aligned for any type.*/
+    static const unsigned int chunkHeaderSize = 64;
+
+    /*A freed block.*/
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    /*Blocks of a thread (see file comment). The counts are signed as
+     *a thread may free more blocks than it allocated.*/
+    struct Cache
+    {
+        pthread_t thread;
+        Cache* next;
+
+        FreeBlock* freeBlocks[numberOfSizeClasses];
+
+        /*Unused part of the last chunk of each size.*/
+        char* unused[numberOfSizeClasses];
+        char* end[numberOfSizeClasses];
+
+        long long bytes;
+        long long blocks;
+        unsigned long long allocations;
+    };
+
+    /*Size class of a block of \argument{bytes}, and the size of the
+     *blocks of a class.*/
+    static unsigned int sizeClassOf(size_t bytes);
+    static unsigned int sizeOf(unsigned int sizeClass);
+
+    /*Header of the chunk holding \argument{block}, $0$ if the block
+     *was allocated on the heap.*/
+    static Chunk* chunkOf(void* block);
+
+    /*Cache of the calling thread, made if there is none.*/
+    Cache* getCache();
+
+    /*The counts of this arena, summed over the \member{caches}. The
+     *caller holds the \member{mutex}.*/
+    void total(long long& bytes, long long& blocks, unsigned long long& allocations)const;
+
+    /*Give the \argument{cache} blocks of the \argument{sizeClass},
+     *from those returned to this arena or from a new chunk. Returns
+     *false if no chunk could be had.*/
+    bool refill(Cache* cache, unsigned int sizeClass);
+
+    /*Allocate a block of \argument{bytes} with a chunk of its own,
+     *$0$ if it could not be had.*/
+    void* allocateLarge(Cache* cache, size_t bytes);
+
+    /*Return a block to this arena, by a thread in which it is not
+     *current. This arena is deleted if it is released and the block
+     *was its last.*/
+    void give(void* block, Chunk* chunk);
+
+    /*A new chunk of \argument{bytes}, registered in the map of
+     *chunks, $0$ if there is no memory or the chunk cannot be
+     *mapped.*/
+    Chunk* takeChunk(size_t bytes, unsigned int sizeClass);
+
+    /*Unregister and free the argument chunk.*/
+    static void freeChunk(Chunk*);
+
+    /*Arena current in the calling thread (see \class{ArenaScope}),
+     *and the cache of the thread in that arena.*/
+    static __thread Arena* current;
+    static __thread Cache* currentCache;
+
+    /*Chunks of blocks, most recently taken first. Chunks of large
+     *blocks are not listed, they are freed with their blocks.*/
+    Chunk* chunks;
+
+    /*Caches of the threads that have used this arena.*/
+    Cache* caches;
+
+    /*Blocks returned by threads in which this arena was not current,
+     *and their counts.*/
+    FreeBlock* freeBlocks[numberOfSizeClasses];
+    long long bytes;
+    long long blocks;
+
+    unsigned long long reservedBytes;
+
+    /*Has the owner released this arena?*/
+    bool released;
+
+    /*Guards the members but for the \member{caches}' blocks.*/
+    mutable pthread_mutex_t mutex;
+
+    /*Ensure that an \class{Arena} cannot be copied.*/
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+};
+
+/*Objects allocated by the calling thread during the life of an
+ *\class{ArenaScope} are allocated from its arena, or from the heap if
+ *the arena is $0$. Scopes nest, the arena current before a scope is
+ *restored at its end.*/
+class ArenaScope
+{
+public:
+    ArenaScope(Arena* arena);
+
+    ~ArenaScope();
+private:
+    /*Arena current before this scope, and the cache of the thread
+     *in that arena.*/
+    Arena* previous;
+    Arena::Cache* previousCache;
+
+    /*Ensure that an \class{ArenaScope} cannot be copied.*/
+    ArenaScope(const ArenaScope&);
+    ArenaScope& operator=(const ArenaScope&);
+};
+
+/*Standard library allocator over the current \class{Arena}. All
+ *\class{ArenaAllocator}s are equal, as a block is returned to the
+ *arena of its chunk.*/
+template<typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef ArenaAllocator<U> other;
+    };
+
+    ArenaAllocator(){}
+
+    ArenaAllocator(const ArenaAllocator&){}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>&){}
+
+    pointer address(reference x)const{return &x;}
+
+    const_pointer address(const_reference x)const{return &x;}
+
+    pointer allocate(size_type n, const void* = 0)
+        {return static_cast<pointer>(Arena::allocate(n * sizeof(T)));}
+
+    void deallocate(pointer p, size_type){Arena::deallocate(p);}
+
+    size_type max_size()const{return size_t(-1) / sizeof(T);}
+
+    void construct(pointer p, const T& value){new(p) T(value);}
+
+    void destroy(pointer p){p->~T();}
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>&, const ArenaAllocator<U>&){return true;}
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>&, const ArenaAllocator<U>&){return false;}
+
+#endif
@@ -110,6 +110,8 @@ using namespace std;
 #include "commandParser.h++"
 #include "Utils.h++"
 #include "ExtADD.h++"
+#include "WorkerPool.h++"
+#include "Instrumentation.h++"
 
 extern HIST_ENTRY **history_list();
 
@@ -177,6 +179,11 @@ PRIVATE CommandInterpreter::CommandInterpreter()
     Registry::getInstance()->setFunction("continue", this, 0);
     Registry::getInstance()->setFunction("clear", this, 0);
     Registry::getInstance()->setFunction("stop", this, 0);
+    Registry::getInstance()->setFunction("threads", this, 0);
+    Registry::getInstance()->setFunction("threads", this, 1);
+    Registry::getInstance()->setFunction("probes", this, 0);
+    Registry::getInstance()->setFunction("probes", this, 1);
+    Registry::getInstance()->setFunction("dumpProbes", this, 1);
 
     read_history(history_file.c_str());
 }
@@ -194,6 +201,9 @@ PUBLIC VIRTUAL CommandInterpreter::~CommandInterpreter()
     Registry::getInstance()->unregister("continue", this);
     Registry::getInstance()->unregister("clear", this);
     Registry::getInstance()->unregister("stop", this);
+    Registry::getInstance()->unregister("threads", this);
+    Registry::getInstance()->unregister("probes", this);
+    Registry::getInstance()->unregister("dumpProbes", this);
 
     if(0 != automaticConstraint) {
         delete automaticConstraint;
@@ -228,6 +238,30 @@ PUBLIC string CommandInterpreter::longHelp(const string &command) const
         return shortHelp(command) + "\n";
     else if (command == "stop")
         return shortHelp(command) + "\n";
+    else if (command == "threads")
+        return shortHelp(command) + "\n" + Utils::wordWrapString(helpIndentSize,
+            "Without a parameter - displays the number of threads.\n\n"
+            "Given a parameter - sets the number of threads that take part in "
+            "value iteration, policy iteration and the expansion of states. "
+            "Results do not depend on the number of threads. The default is 1.");
+    else if (command == "probes")
+        return shortHelp(command) + "\n" + Utils::wordWrapString(helpIndentSize,
+            "Without a parameter - displays, for each probe, the number of items "
+            "it has seen and the time spent in it.\n\n"
+            "Given a parameter - \"on\" starts counting and timing, \"trace\" "
+            "also records every timed scope for \"dumpProbes\", \"off\" stops "
+            "both and \"reset\" zeroes the probes. Probes are off by default, "
+            "when they cost the test of a flag.\n\n"
+            "The probes are successor generation, state store lookups and "
+            "insertions, reward progression and regression, formula "
+            "simplification, Bellman backups and decision diagram operations "
+            "and reordering.");
+    else if (command == "dumpProbes")
+        return shortHelp(command) + "\n" + Utils::wordWrapString(helpIndentSize,
+            "The file is in the JSON trace event format, which can be viewed "
+            "with chrome://tracing or Perfetto. Only scopes recorded while "
+            "tracing (see \"probes\") are written as events, the totals of "
+            "every probe are included.");
     else
         return shortHelp(command);
 }
@@ -246,6 +280,12 @@ PUBLIC string CommandInterpreter::shortHelp(const string &command) const
         return shortHelpLine(command, "Terminate interrupted operation.");
     else if (command == "clear")
         return shortHelpLine(command, "Clear the current domain.");
+    else if (command == "threads")
+        return shortHelpLine("threads [number]", "Number of threads used by the solution methods (optional).");
+    else if (command == "probes")
+        return shortHelpLine("probes [on|trace|off|reset]", "Counters and timers of the solution methods.");
+    else if (command == "dumpProbes")
+        return shortHelpLine("dumpProbes(file)", "Write the events recorded by the probes to a trace file.");
     return "";
 }
 
@@ -267,6 +307,42 @@ PUBLIC void CommandInterpreter::commandIssued(const string &command, const vecto
     {
         configureDomainSpecification();
     }   
+    else if (command == "threads")
+    {
+        if (parameters.size())
+        {
+            const char *number = parameters[0].c_str();
+            char *end;
+            long threads = strtol(number, &end, 10);
+
+            if (end == number || *end != '\0' || threads < 1)
+                cerr << "threads: expected a whole number of at least 1\n";
+            else
+                WorkerPool::getInstance()->setThreads(threads);
+        }
+        else
+            commandResult = Utils::doubleToString(WorkerPool::getInstance()->getThreads(), 0);
+    }
+    else if (command == "probes")
+    {
+        if (!parameters.size())
+            commandResult = Instrumentation::report();
+        else if (parameters[0] == "on")
+            Instrumentation::setEnabled(true);
+        else if (parameters[0] == "trace")
+            Instrumentation::setTracing(true);
+        else if (parameters[0] == "off")
+            Instrumentation::setEnabled(false);
+        else if (parameters[0] == "reset")
+            Instrumentation::reset();
+        else
+            cerr << "probes: expected one of on, trace, off or reset\n";
+    }
+    else if (command == "dumpProbes")
+    {
+        if (!Instrumentation::dumpTrace(parameters[0]))
+            cerr << "dumpProbes: could not write " << parameters[0] << "\n";
+    }
 }
 
 PUBLIC int CommandInterpreter::getLine(string &result)
@@ -0,0 +1,331 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include"CompressedDynamics.h++"
+#include"DomainImage.h++"
+
+#include"States.h++"
+#include"actionSpecification.h++"
+#include"WorkerPool.h++"
+#include"Instrumentation.h++"
+
+#include<cassert>
+#include<cmath>
+#include<algorithm>
+
+using namespace MDP;
+
+const unsigned int CompressedDynamics::noChoice;
+
+/*Fewest states backed up by a thread of the \class{WorkerPool}.*/
+static const unsigned int backupGrain = 1024;
+
+/*Order successor entries by state identifier alone.*/
+static bool successorPrecedes(const pair<unsigned int, double>& first,
+                              const pair<unsigned int, double>& second)
+{
+    return first.first < second.first;
+}
+
+/*Backups of a block of states (see
+ *\method{CompressedDynamics::backupStates()}).*/
+class StateBackups : public ParallelTask
+{
+public:
+    StateBackups(const CompressedDynamics& dynamics,
+                 const double* values,
+                 double gamma,
+                 vector<double>& results,
+                 vector<unsigned int>& bestChoices)
+        :dynamics(dynamics),
+         values(values),
+         gamma(gamma),
+         results(results),
+         bestChoices(bestChoices){}
+
+    void operator()(unsigned int begin, unsigned int end, unsigned int)
+    {
+        for(unsigned int state = begin; state != end; ++state)
+            results[state] = dynamics.backup(state, values, gamma, bestChoices[state]);
+    }
+private:
+    const CompressedDynamics& dynamics;
+    const double* values;
+    double gamma;
+    vector<double>& results;
+    vector<unsigned int>& bestChoices;
+};
+
+/*Greatest element of the difference between two vectors, one
+ *partial result per block (see
+ *\method{CompressedDynamics::difference()}).*/
+class BlockDifference : public ParallelTask
+{
+public:
+    BlockDifference(const vector<double>& first,
+                    const vector<double>& second,
+                    vector<double>& norms)
+        :first(first),
+         second(second),
+         norms(norms){}
+
+    void operator()(unsigned int begin, unsigned int end, unsigned int block)
+    {
+        double norm = first[begin] - second[begin];
+        for(unsigned int i = begin + 1; i < end; ++i)
+            norm = max(norm, first[i] - second[i]);
+        norms[block] = norm;
+    }
+private:
+    const vector<double>& first;
+    const vector<double>& second;
+    vector<double>& norms;
+};
+
+        /*
+         *Construction
+         */
+
+CompressedDynamics::CompressedDynamics()
+{
+    clear();
+}
+
+void CompressedDynamics::clear()
+{
+    actions.clear();
+    actionIds.clear();
+    choiceActions.clear();
+    successors.clear();
+    probabilities.clear();
+
+    stateOffsets.assign(1, 0);
+    choiceOffsets.assign(1, 0);
+
+    viewing = false;
+    own();
+}
+
+void CompressedDynamics::view(const DomainImage& image)
+{
+    clear();
+
+    for(unsigned int a = 0; a < image.numberOfActions(); ++a)
+    {
+        actionIds[image.getAction(a)] = actions.size();
+        actions.push_back(image.getAction(a));
+    }
+
+    stateOffsetData = image.getStateOffsets();
+    choiceActionData = image.getChoiceActions();
+    choiceOffsetData = image.getChoiceOffsets();
+    successorData = image.getSuccessors();
+    probabilityData = image.getProbabilities();
+
+    states = image.numberOfStates();
+    choices = image.numberOfChoices();
+    transitions = image.numberOfTransitions();
+
+    viewing = true;
+}
+
+void CompressedDynamics::own()
+{
+    stateOffsetData = &stateOffsets[0];
+    choiceActionData = choiceActions.empty() ? 0 : &choiceActions[0];
+    choiceOffsetData = &choiceOffsets[0];
+    successorData = successors.empty() ? 0 : &successors[0];
+    probabilityData = probabilities.empty() ? 0 : &probabilities[0];
+
+    states = stateOffsets.size() - 1;
+    choices = choiceActions.size();
+    transitions = successors.size();
+}
+
+void CompressedDynamics::setActions(const ActionSpecification& actionSpecification)
+{
+    actions.clear();
+    actionIds.clear();
+
+    for(ActionSpecification::const_iterator a = actionSpecification.begin()
+            ; a != actionSpecification.end()
+            ; ++a)
+    {
+        actionIds[a->first] = actions.size();
+        actions.push_back(a->first);
+    }
+}
+
+        /*
+         *Functionality
+         */
+
+void CompressedDynamics::addState(eState* state,
+                                  const map<eState*, int>& stateIds,
+                                  bool empty)
+{
+    assert(!viewing);
+
+    if(!empty)
+        /*For each action possible at the state. These are visited in
+          the order of \member{actions}.*/
+        for(State::iterator stateAction = state->begin()
+                ; stateAction != state->end()
+                ; ++stateAction)
+        {
+            map<action, unsigned int>::const_iterator actionId
+                = actionIds.find(stateAction->first);
+
+            if(actionIds.end() == actionId)
+                continue;
+
+            row.clear();
+
+            /*For each possible transition given the action.*/
+            for(ActionPossibilities::const_iterator transitionPair
+                    = stateAction->second.begin()
+                    ; transitionPair != stateAction->second.end()
+                    ; ++transitionPair)
+            {
+                map<eState*, int>::const_iterator successor
+                    = stateIds.find(dynamic_cast<eState*>(transitionPair->second));
+
+                if(stateIds.end() != successor)
+                    row.push_back(pair<unsigned int, double>
+                                  (successor->second, transitionPair->first));
+            }
+
+            /*Successors are stored in order of identifier. Where a
+              successor occurs twice the last probability is kept, as
+              it is by the assignment of the matrix entry in
+              \method{ValueIteration::configureActions()}.*/
+            stable_sort(row.begin(), row.end(), successorPrecedes);
+
+            for(vector<pair<unsigned int, double> >::const_iterator entry = row.begin()
+                    ; entry != row.end()
+                    ; ++entry)
+                if(successors.size() != choiceOffsets.back()
+                   && successors.back() == entry->first)
+                    probabilities.back() = entry->second;
+                else
+                {
+                    successors.push_back(entry->first);
+                    probabilities.push_back(entry->second);
+                }
+
+            choiceActions.push_back(actionId->second);
+            choiceOffsets.push_back(successors.size());
+        }
+
+    stateOffsets.push_back(choiceActions.size());
+
+    /*The vectors may have been reallocated.*/
+    own();
+}
+
+        /*
+         *Queries + Accessors
+         */
+
+bool CompressedDynamics::isView()const
+{
+    return viewing;
+}
+
+unsigned int CompressedDynamics::numberOfStates()const
+{
+    return states;
+}
+
+unsigned int CompressedDynamics::numberOfChoices()const
+{
+    return choices;
+}
+
+unsigned int CompressedDynamics::numberOfTransitions()const
+{
+    return transitions;
+}
+
+unsigned int CompressedDynamics::findChoice(unsigned int state, const action& act)const
+{
+    map<action, unsigned int>::const_iterator actionId = actionIds.find(act);
+
+    if(actionIds.end() == actionId)
+        return noChoice;
+
+    for(unsigned int choice = stateOffsetData[state]
+            ; choice != stateOffsetData[state + 1]
+            ; ++choice)
+        if(choiceActionData[choice] == actionId->second)
+            return choice;
+
+    return noChoice;
+}
+
+void CompressedDynamics::backupStates(const double* values,
+                                      double gamma,
+                                      vector<double>& results,
+                                      vector<unsigned int>& bestChoices)const
+{
+    assert(results.size() == numberOfStates());
+    assert(bestChoices.size() == numberOfStates());
+
+    ScopedTimer timer(Instrumentation::bellmanBackup, numberOfStates());
+
+    StateBackups task(*this, values, gamma, results, bestChoices);
+    WorkerPool::getInstance()->run(task, numberOfStates(), backupGrain);
+}
+
+double CompressedDynamics::difference(const vector<double>& first, const vector<double>& second)
+{
+    assert(first.size() == second.size());
+
+    WorkerPool* pool = WorkerPool::getInstance();
+
+    /*Every block writes only its own norm.*/
+    vector<double> norms(pool->blocks(first.size(), backupGrain), 0.0);
+
+    if(0 != first.size())
+    {
+        BlockDifference task(first, second, norms);
+        pool->run(task, first.size(), backupGrain);
+    }
+
+    return *max_element(norms.begin(), norms.end());
+}
+
+/*The rows of a view are those of the \class{DomainImage}, which are
+ *not counted.*/
+unsigned int CompressedDynamics::memory()const
+{
+    unsigned int size = sizeof(*this);
+
+    for(vector<action>::const_iterator a = actions.begin()
+            ; a != actions.end()
+            ; ++a)
+        size += 2 * (sizeof(*a) + sizeof(char) * a->size() + sizeof(unsigned int));
+
+    size += sizeof(unsigned int) * (stateOffsets.capacity()
+                                    + choiceActions.capacity()
+                                    + choiceOffsets.capacity()
+                                    + successors.capacity());
+    size += sizeof(double) * probabilities.capacity();
+    size += sizeof(pair<unsigned int, double>) * row.capacity();
+
+    return size;
+}
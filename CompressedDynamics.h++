@@ -0,0 +1,245 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+/*
+ * \paragraph{:Purpose:}
+ *
+ * Compressed sparse row (CSR) storage of the system dynamics of an
+ * explicit domain. Where \module{ValueIteration} keeps one sparse
+ * matrix per action, here the dynamics of all actions are kept in a
+ * single structure. Each state owns a contiguous run of
+ * \emph{choices}, one per action executable at that state, and each
+ * choice owns a contiguous run of successor state identifiers and
+ * their probabilities. Thus a Bellman backup of a state is a walk
+ * over contiguous memory.
+ *
+ * This structure is the basis of \class{CompressedValueIteration} and
+ * \class{CompressedPolicyIteration}.
+ *
+ * The rows are either owned, built by \method{addState()}, or are a
+ * view of the rows of a mapped \class{DomainImage}. The backups only
+ * read the rows through the pointers of the structure, thus they are
+ * the same in either case.
+ **/
+#ifndef COMPRESSED_DYNAMICS
+#define COMPRESSED_DYNAMICS
+
+#include"SpecificationTypes.h++"
+
+using namespace std;
+
+namespace MDP
+{
+    class DomainImage;
+
+    class CompressedDynamics
+    {
+    public:
+        /*Identifier of the absence of a choice.*/
+        static const unsigned int noChoice = ~0U;
+
+        /*Construction of an empty structure with no actions.*/
+        CompressedDynamics();
+
+        /*Forget all the rows and actions.*/
+        void clear();
+
+        /*Set the actions that choices may refer to. Choices of a
+         *state are ordered as the actions of the argument
+         *\class{ActionSpecification}.*/
+        void setActions(const ActionSpecification&);
+
+        /*Append the row of the argument state. Successors not indexed
+         *by \argument{stateIds} are ignored. A successor that occurs
+         *more than once in a transition has the last probability
+         *given for it, as in the action matrices of
+         *\class{ValueIteration}. If \argument{empty} is
+         *$true$ the row has no choices, this is the case for states
+         *whose transitions are not to be considered.
+         *
+         *Rows cannot be appended to a view (see \method{view()}).*/
+        void addState(eState*, const map<eState*, int>& stateIds, bool empty = false);
+
+        /*Forget all the rows and actions and take those of the
+         *argument \class{DomainImage}. The rows are not copied, thus
+         *the image must remain open while this structure is in
+         *use.*/
+        void view(const DomainImage&);
+
+        /*Are the rows those of a \class{DomainImage}?*/
+        bool isView()const;
+
+        /*Number of rows.*/
+        unsigned int numberOfStates()const;
+
+        /*Number of choices over all the rows.*/
+        unsigned int numberOfChoices()const;
+
+        /*Number of successor entries over all the choices.*/
+        unsigned int numberOfTransitions()const;
+
+        /*First choice of the argument state.*/
+        unsigned int beginChoice(unsigned int state)const
+            {return stateOffsetData[state];}
+
+        /*One past the last choice of the argument state.*/
+        unsigned int endChoice(unsigned int state)const
+            {return stateOffsetData[state + 1];}
+
+        /*Action associated with the argument choice.*/
+        const action& getAction(unsigned int choice)const
+            {return actions[choiceActionData[choice]];}
+
+        /*Index into the actions of the argument choice. Actions are
+         *indexed in the order of \method{getActions()}.*/
+        unsigned int getActionId(unsigned int choice)const
+            {return choiceActionData[choice];}
+
+        /*Actions that choices may refer to, in order.*/
+        const vector<action>& getActions()const
+            {return actions;}
+
+        /*First successor entry of the argument choice.*/
+        unsigned int beginSuccessor(unsigned int choice)const
+            {return choiceOffsetData[choice];}
+
+        /*One past the last successor entry of the argument choice.*/
+        unsigned int endSuccessor(unsigned int choice)const
+            {return choiceOffsetData[choice + 1];}
+
+        /*State identifier of the argument successor entry.*/
+        unsigned int getSuccessor(unsigned int entry)const
+            {return successorData[entry];}
+
+        /*Probability of the argument successor entry.*/
+        double getProbability(unsigned int entry)const
+            {return probabilityData[entry];}
+
+        /*Choice of the argument state associated with the
+         *\argument{action}, or \member{noChoice} if that action is not
+         *executable at the state.*/
+        unsigned int findChoice(unsigned int state, const action&)const;
+
+        /*Expected value of the argument choice given the
+         *\argument{values} of all the states. Successors are summed in
+         *order of their identifier.*/
+        double expectation(unsigned int choice, const double* values)const
+            {
+                double sum = 0.0;
+                for(unsigned int i = choiceOffsetData[choice]
+                        ; i != choiceOffsetData[choice + 1]
+                        ; ++i)
+                    sum += probabilityData[i] * values[successorData[i]];
+                return sum;
+            }
+
+        /*Bellman backup of the argument \argument{state}. The result
+         *is the greatest discounted expectation over the choices of
+         *the state, or $0$ if none is positive. The maximising
+         *choice, the first of those that are equal, is stored in
+         *\argument{choice}. Where no choice is positive
+         *\argument{choice} is \member{noChoice}.*/
+        double backup(unsigned int state,
+                      const double* values,
+                      double gamma,
+                      unsigned int& choice)const
+            {
+                double best = 0.0;
+                choice = noChoice;
+                for(unsigned int c = stateOffsetData[state]
+                        ; c != stateOffsetData[state + 1]
+                        ; ++c)
+                {
+                    double tmp = gamma * expectation(c, values);
+                    if(tmp > best)
+                    {
+                        best = tmp;
+                        choice = c;
+                    }
+                }
+                return best;
+            }
+
+        /*Bellman backup (see \method{backup()}) of every state into
+         *\argument{results} and \argument{bestChoices}, both of
+         *which must have an element per state. The states are divided
+         *among the threads of the \class{WorkerPool}. Each state is
+         *backed up exactly as by \method{backup()}, thus the result
+         *does not depend on the number of threads.*/
+        void backupStates(const double* values,
+                          double gamma,
+                          vector<double>& results,
+                          vector<unsigned int>& bestChoices)const;
+
+        /*Greatest element of the first argument less the second, as
+         *in \method{ValueIteration::terminate()}. The arguments
+         *have the same size. The maximum of each block of a
+         *\class{WorkerPool} task is computed separately.*/
+        static double difference(const vector<double>&, const vector<double>&);
+
+        /*Approximately the amount of memory taken by this
+         *structure. The result is a number of bytes.*/
+        unsigned int memory()const;
+    private:
+        /*Point the data of the rows at the owned vectors.*/
+        void own();
+
+        /*Actions in order.*/
+        vector<action> actions;
+
+        /*Index of \member{actions}.*/
+        map<action, unsigned int> actionIds;
+
+        /*Choices of state $i$ are those from $stateOffsets[i]$ to
+         *$stateOffsets[i + 1]$.*/
+        vector<unsigned int> stateOffsets;
+
+        /*Index into \member{actions} of every choice.*/
+        vector<unsigned int> choiceActions;
+
+        /*Successors of choice $i$ are those from $choiceOffsets[i]$
+         *to $choiceOffsets[i + 1]$.*/
+        vector<unsigned int> choiceOffsets;
+
+        /*Successor state identifiers.*/
+        vector<unsigned int> successors;
+
+        /*Probability of the successor at the same index.*/
+        vector<double> probabilities;
+
+        /*Scratch row used during \method{addState()}.*/
+        vector<pair<unsigned int, double> > row;
+
+        /*Data of the rows read by the queries, either that of the
+         *owned vectors above or that of a \class{DomainImage}.*/
+        const unsigned int* stateOffsetData;
+        const unsigned int* choiceActionData;
+        const unsigned int* choiceOffsetData;
+        const unsigned int* successorData;
+        const double* probabilityData;
+
+        /*Counts of the rows.*/
+        unsigned int states;
+        unsigned int choices;
+        unsigned int transitions;
+
+        /*Are the rows those of a \class{DomainImage}?*/
+        bool viewing;
+    };
+}
+
+#endif
@@ -0,0 +1,421 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include<cassert>
+#include<cmath>
+
+#include"CompressedPolicyIteration.h++"
+#include"domainSpecification_Anytime_or_Explicit.h++"
+#include"WorkerPool.h++"
+#include"Instrumentation.h++"
+
+/*Fewest states improved by a thread of the \class{WorkerPool}.*/
+static const unsigned int improvementGrain = 1024;
+
+/*Largest error of a state value given by a policy evaluation.*/
+static const double evaluationError = 1e-10;
+
+/*Amount by which a choice must be better than the choice of the
+ *policy to replace it. The values of two choices computed from an
+ *evaluation are each within $\gamma$ \variable{evaluationError} of
+ *their true values.*/
+static const double improvementMargin = 2 * evaluationError;
+
+/*Most sweeps of an evaluation without discounting, whose values need
+ *not converge (see \method{CompressedPolicyIteration::evaluatePolicy()}).*/
+static const unsigned int undiscountedSweeps = 10000;
+
+/*Policy improvement of a block of states (see
+ *\method{CompressedPolicyIteration::operator()()}). A state is
+ *improved if some choice is better than that of the policy by more
+ *than the \variable{improvementMargin}, the best such choice is
+ *stored.*/
+class PolicyImprovement : public ParallelTask
+{
+public:
+    PolicyImprovement(const CompressedDynamics& dynamics,
+                      const double* values,
+                      const vector<double>& initialReward,
+                      const vector<unsigned int>& choices,
+                      double gamma,
+                      vector<unsigned int>& improvedChoices,
+                      vector<char>& improved)
+        :dynamics(dynamics),
+         values(values),
+         initialReward(initialReward),
+         choices(choices),
+         gamma(gamma),
+         improvedChoices(improvedChoices),
+         improved(improved){}
+
+    void operator()(unsigned int begin, unsigned int end, unsigned int)
+    {
+        for(unsigned int j = begin; j != end; ++j)
+        {
+            unsigned int current = choices[j];
+
+            improved[j] = false;
+            improvedChoices[j] = current;
+
+            if(CompressedDynamics::noChoice == current)
+                continue;
+
+            /*Value a choice must exceed to improve the policy.*/
+            double bestValue = gamma * dynamics.expectation(current, values)
+                + initialReward[j] + improvementMargin;
+
+            for(unsigned int choice = dynamics.beginChoice(j)
+                    ; choice != dynamics.endChoice(j)
+                    ; ++choice)
+            {
+                if(choice == current)
+                    continue;
+
+                double tmp = gamma * dynamics.expectation(choice, values)
+                    + initialReward[j];
+
+                /*Was this choice superior?*/
+                if(tmp > bestValue)
+                {
+                    bestValue = tmp;
+                    improvedChoices[j] = choice;
+                    improved[j] = true;
+                }
+            }
+        }
+    }
+private:
+    const CompressedDynamics& dynamics;
+    const double* values;
+    const vector<double>& initialReward;
+    const vector<unsigned int>& choices;
+    double gamma;
+    vector<unsigned int>& improvedChoices;
+
+    /*Not a vector of bool, so that blocks write distinct bytes.*/
+    vector<char>& improved;
+};
+
+CompressedPolicyIteration::CompressedPolicyIteration(DomainSpecification* domSpec)
+    : Algorithm(*domSpec),
+      iteration(0),
+      stateId(0)
+{
+    cerr<<"An attempt to execute explicit policy iteration with a non--explicit domain will fail!\n";
+}
+
+CompressedPolicyIteration::CompressedPolicyIteration(explicitDomainSpecification& domSpec,
+                                                     double gamma,
+                                                     double epsilon,
+                                                     bool delayInitialisation)
+    : Algorithm(domSpec, gamma, epsilon),
+      iteration(0),
+      stateId(0)
+{
+    if(!delayInitialisation)
+    {
+        domainStates = domSpec.getStates(domainStates);
+
+        identifyStates();
+
+        initialiseActions();
+
+        configureActions();
+
+        initialiseValueVectors();
+
+        configurePolicy(domSpec);
+    }
+}
+
+CompressedPolicyIteration::CompressedPolicyIteration(explicitDomainSpecification& domSpec)
+    : Algorithm(domSpec),
+      iteration(0),
+      stateId(0)
+{
+    domainStates = domSpec.getStates(domainStates);
+
+    identifyStates();
+
+    initialiseActions();
+
+    configureActions();
+
+    initialiseValueVectors();
+
+    configurePolicy(domSpec);
+}
+
+CompressedPolicyIteration::CompressedPolicyIteration(const DomainImage& image,
+                                                     DomainSpecification& domSpec,
+                                                     double gamma,
+                                                     double epsilon)
+    : Algorithm(domSpec, gamma, epsilon),
+      iteration(0),
+      policy(0),
+      stateId(0)
+{
+    dynamics.view(image);
+
+    initialiseValueVectors(image);
+}
+
+void CompressedPolicyIteration::configurePolicy(explicitDomainSpecification& domSpec)
+{
+    policy = domSpec.getPolicy();
+}
+
+void CompressedPolicyIteration::initialiseValueVectors()
+{
+    lastIteration = vector<double>(domainStates.size(), 0.0);
+
+    initialReward = vector<double>(domainStates.size(), 0.0);
+
+    choices = vector<unsigned int>(domainStates.size(), CompressedDynamics::noChoice);
+
+    improvedChoices = vector<unsigned int>(domainStates.size(), CompressedDynamics::noChoice);
+
+    improved = vector<char>(domainStates.size(), false);
+
+    for(vector<eState*>::const_iterator domainState = domainStates.begin()
+            ; domainState != domainStates.end()
+            ; ++domainState)
+    {
+        int id = stateIds[*domainState];
+
+        /*If the state is expanded then all transitional information
+          has been removed and the value associated with that state is
+          the expected reward.*/
+        if(FRINGE == (*domainState)->getColour()
+           || IMPLICIT == (*domainState)->getColour())
+            initialReward[id] = (*domainState)->getValue();
+        else
+            initialReward[id] = (*domainState)->getReward();
+
+        lastIteration[id] = initialReward[id];
+    }
+
+    /*The first evaluation begins from the immediate reward.*/
+    thisIteration = lastIteration;
+}
+
+void CompressedPolicyIteration::initialiseValueVectors(const DomainImage& image)
+{
+    unsigned int states = image.numberOfStates();
+
+    lastIteration = vector<double>(states, 0.0);
+
+    initialReward = vector<double>(states, 0.0);
+
+    choices = vector<unsigned int>(states, CompressedDynamics::noChoice);
+
+    improvedChoices = vector<unsigned int>(states, CompressedDynamics::noChoice);
+
+    improved = vector<char>(states, false);
+
+    for(unsigned int id = 0; id < states; ++id)
+    {
+        /*As for the states of a domain, see above.*/
+        if(FRINGE == image.getColour(id) || IMPLICIT == image.getColour(id))
+            initialReward[id] = image.getValue(id);
+        else
+            initialReward[id] = image.getReward(id);
+
+        lastIteration[id] = initialReward[id];
+
+        /*The policy of the image is the first to be evaluated.*/
+        choices[id] = image.getPolicyChoice(id);
+    }
+
+    thisIteration = lastIteration;
+}
+
+void CompressedPolicyIteration::configureActions(bool ignoreExplicit)
+{
+    configureActions(domainStates.begin(), ignoreExplicit);
+}
+
+void CompressedPolicyIteration::configureActions(vector<eState*>::const_iterator domainState, bool ignoreExplicit)
+{
+    /*Rows are appended, thus the states must be configured in order
+      of identity.*/
+    assert(domainState == domainStates.end()
+           || static_cast<int>(dynamics.numberOfStates()) == stateIds[*domainState]);
+
+    for(; domainState != domainStates.end(); ++domainState)
+        dynamics.addState(*domainState,
+                          stateIds,
+                          !ignoreExplicit && EXPLICIT != (*domainState)->getColour());
+}
+
+void CompressedPolicyIteration::identifyStates()
+{
+    stateId = 0;
+    identifyStates(domainStates.begin());
+}
+
+void CompressedPolicyIteration::identifyStates(vector<eState*>::const_iterator domainState)
+{
+    /*Make the states identifiable.*/
+    for(; domainState != domainStates.end()
+            ; ++domainState, ++stateId)
+        stateIds[*domainState] = stateId;
+}
+
+void CompressedPolicyIteration::initialiseActions()
+{
+    dynamics.clear();
+    dynamics.setActions(*domSpec->getActionSpecification());
+}
+
+void CompressedPolicyIteration::updateStateValues()
+{
+    for(unsigned int i = 0; i < domainStates.size(); ++i)
+        domainStates[i]->setValue(thisIteration[i]);
+}
+
+bool CompressedPolicyIteration::terminate(const vector<double>& thisIteration,
+                                          const vector<double>& lastIteration)
+{
+    double norm = CompressedDynamics::difference(thisIteration, lastIteration);
+
+    Algorithm::error = norm;
+
+    return (norm <= (epsilon * ((1 - gamma)/(2*gamma))));
+}
+
+void CompressedPolicyIteration::evaluatePolicy()
+{
+    double* values = &thisIteration[0];
+
+    /*A Gauss--Seidel sweep is a $\gamma$ contraction in the supremum
+      norm, thus where the largest change of a sweep is $\delta$ the
+      values are within $\gamma \delta / (1 - \gamma)$ of those of the
+      policy. Without discounting there is no such bound, then sweeps
+      are made until the change is at most \variable{evaluationError}.
+      The values of a policy that may cycle forever gaining reward
+      grow without bound, thus at most \variable{undiscountedSweeps}
+      sweeps are made.*/
+    double threshold = (gamma < 1.0)
+        ? evaluationError * (1 - gamma) / gamma
+        : evaluationError;
+    unsigned int sweeps = 0;
+
+    for(double change = threshold + 1.0
+            ; change > threshold && (gamma < 1.0 || sweeps < undiscountedSweeps)
+            ; ++sweeps)
+    {
+        change = 0.0;
+
+        for(unsigned int j = 0; j < numberOfStates(); ++j)
+        {
+            double value = initialReward[j];
+
+            if(CompressedDynamics::noChoice != choices[j])
+                value += gamma * dynamics.expectation(choices[j], values);
+
+            change = max(change, fabs(value - values[j]));
+            values[j] = value;
+        }
+    }
+}
+
+unsigned int CompressedPolicyIteration::numberOfStates()const
+{
+    return dynamics.isView() ? dynamics.numberOfStates() : domainStates.size();
+}
+
+const vector<double>& CompressedPolicyIteration::getValues()const
+{
+    return thisIteration;
+}
+
+const vector<unsigned int>& CompressedPolicyIteration::getChoices()const
+{
+    return choices;
+}
+
+bool CompressedPolicyIteration::operator()()
+{
+    iteration++;
+
+    if(0 == numberOfStates())
+        return true;
+
+    /*Has the policy been altered by this iteration?*/
+    bool policyChanged = false;
+
+    /*Obtain the choice of the policy at every state. Without a
+      \member{policy} the \member{choices} are the policy.*/
+    for(unsigned int j = 0; j < numberOfStates(); ++j)
+    {
+        if(0 != policy)
+        {
+            Policy::iterator act = policy->find(domainStates[j]);
+
+            if(policy->end() != act)
+                choices[j] = dynamics.findChoice(j, act->second);
+            else
+                choices[j] = CompressedDynamics::noChoice;
+        }
+
+        /*Otherwise, must be a fringe state or a state new to the
+          policy. The first action possible at the state is taken.*/
+        if(CompressedDynamics::noChoice == choices[j]
+           && dynamics.beginChoice(j) != dynamics.endChoice(j))
+        {
+            choices[j] = dynamics.beginChoice(j);
+            if(0 != policy)
+                (*policy)[domainStates[j]] = dynamics.getAction(choices[j]);
+            policyChanged = true;
+        }
+    }
+
+    /*Solve $V_pi = initialReward + gamma P_pi V_pi$.*/
+    evaluatePolicy();
+
+    /*Improve the policy at every state. The states are improved
+      concurrently, the policy is written after.*/
+    {
+        ScopedTimer timer(Instrumentation::bellmanBackup, numberOfStates());
+
+        PolicyImprovement improvement(dynamics,
+                                      &thisIteration[0],
+                                      initialReward,
+                                      choices,
+                                      gamma,
+                                      improvedChoices,
+                                      improved);
+        WorkerPool::getInstance()->run(improvement, numberOfStates(), improvementGrain);
+    }
+
+    for(unsigned int j = 0; j < numberOfStates(); ++j)
+    {
+        if(improved[j])
+        {
+            choices[j] = improvedChoices[j];
+            if(0 != policy)
+                (*policy)[domainStates[j]] = dynamics.getAction(choices[j]);
+            policyChanged = true;
+        }
+    }
+
+    terminate(thisIteration, lastIteration);
+    lastIteration = thisIteration;
+
+    return !policyChanged;
+}
@@ -0,0 +1,207 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+/*
+ * \paragraph{:Purpose:}
+ *
+ * Policy iteration over \class{CompressedDynamics}. Where
+ * \class{PolicyIteration} evaluates a policy by dense LU
+ * factorisation, here the evaluation is iterative. Gauss--Seidel
+ * sweeps are made over the choices of the policy, using values of
+ * the current sweep as soon as they are available, until the values
+ * are within a small bound of those of the policy. Successive
+ * evaluations begin from the values of the last policy.
+ *
+ * As the evaluation is approximate, policy improvement keeps the
+ * choice of a state unless another choice is better by more than the
+ * evaluation error allows. Thus the iteration stops once no choice is
+ * better by that margin, rather than alternating between choices of
+ * equal value.
+ * */
+#ifndef COMPRESSED_POLICY_ITERATION
+#define COMPRESSED_POLICY_ITERATION
+
+#include "Algorithm.h++"
+#include "CompressedDynamics.h++"
+#include "DomainImage.h++"
+
+using namespace std;
+
+namespace MDP
+{
+    class CompressedPolicyIteration : public Algorithm
+    {
+    public:
+        /*Policy iteration can be used as the dynamic programming step
+         *in \class{LAO}.*/
+        friend class LAO<CompressedPolicyIteration>;
+
+        /*A call to this constructor results in erroneous behaviour as
+         *this is a state based algorithm (ie: requires an
+         *\class{explicitDomainSpecification}).*/
+        CompressedPolicyIteration(DomainSpecification* domSpec);
+
+        /*Construct the algorithmic object with \argument{domSpec} as
+         *the specification on which the algorithms is to be executed,
+         *\argument{gamma} the discount factor and \argument{epsilon}
+         *the acceptable error. The \argument{epsilon} is included for
+         *convenience and not necessity (see \function{terminate()}).
+         *
+         *A client who desires finer grained control over the
+         *configuration of this \class{Algorithm} should pass an
+         *\argument{delayInitialisation} value of $true$.*/
+        CompressedPolicyIteration(explicitDomainSpecification& domSpec,
+                                 double gamma,
+                                 double epsilon,
+                                 bool delayInitialisation = false);
+
+        /*Construct the algorithmic object with \argument{domSpec} as
+         *the specification on which the algorithms is to be
+         *executed. Discounting and error is taken to be the defaults
+         *provided by the \parent{Algorithm}.*/
+        CompressedPolicyIteration(explicitDomainSpecification& domSpec);
+
+        /*Construct the algorithmic object over the states of the
+         *argument \class{DomainImage}, which must remain open while
+         *this algorithm is in use. The rows of the image are not
+         *copied (see \method{CompressedDynamics.view()}). There are no
+         *\class{eState}s, thus the policy is that given by
+         *\method{getChoices()}. The \argument{domSpec} is that of the
+         *\parent{Algorithm}.*/
+        CompressedPolicyIteration(const DomainImage& image,
+                                  DomainSpecification& domSpec,
+                                  double gamma,
+                                  double epsilon);
+
+        /*Set the algorithm policy to that of the
+         *\argument{explicitDomainSpecification}*/
+        void configurePolicy(explicitDomainSpecification&);
+
+        /*Initialise \member{lastIteration} value to state values
+         *\member{State.getValue()} and \member{initialReward} to
+         *\member{domSpec} \class{State} immediate reward
+         *\member{State.getReward()}.
+         *
+         *This function also accommodates state colourings. If states
+         *are coloured as either FRINGE or IMPLICIT then the immediate
+         *reward is considered to be \member{State.getValue()}.*/
+        void initialiseValueVectors();
+
+        /*As \method{initialiseValueVectors()}, given the rewards,
+         *values, colours and policy of the argument image.*/
+        void initialiseValueVectors(const DomainImage&);
+
+        /*Append the rows of the states from \argument{domainState}
+         *onwards to the \member{dynamics}. The rows of the states
+         *before \argument{domainState} must already be present.
+         *
+         *Unless \argument{ignoreExplicit} is $true$ only EXPLICIT
+         *states have transitions, and only those to states in
+         *\member{stateIds}.*/
+        void configureActions(vector<eState*>::const_iterator domainState, bool ignoreExplicit = true);
+
+        /*Assigns integer identities to all the \member{domSpec}
+         *states. The resultant mapping from states an integers is
+         *available in \member{stateIds}*/
+        void identifyStates(vector<eState*>::const_iterator domainState);
+
+        /*See \member{configureActions}.*/
+        void configureActions(bool ignoreExplicit = true);
+
+        /*See \member{identifyStates}.*/
+        void identifyStates();
+
+        /*Empty the \member{dynamics} and set its actions to those of
+         *the domain.*/
+        void initialiseActions();
+
+        /*Update the value associated with elements of
+         *\member{domainStates} to include the n--iterate values
+         *resulting from the last iteration of this algorithm.*/
+        void updateStateValues();
+
+        /*Don't let the name fool you! Has this algorithm found a
+         *solution with suitable error? The arguments are the current
+         *and last iteration values respectively.
+         *\member{Algorithm::error} is updated when a call is made and
+         *is the greatest element of their difference, as for
+         *\class{PolicyIteration}.*/
+        bool terminate(const vector<double>& thisIteration, const vector<double>& lastIteration);
+
+        /*Execute an iteration of this algorithm. $true$ is returned
+         *when the policy is unchanged by the iteration.*/
+        bool operator()();
+
+        /*Value of each state after the last iteration.*/
+        const vector<double>& getValues()const;
+
+        /*Choice (see \class{CompressedDynamics}) of the policy at each
+         *state, \member{CompressedDynamics::noChoice} where there is
+         *none.*/
+        const vector<unsigned int>& getChoices()const;
+    protected:
+        /*Evaluate the policy given by \member{choices}. The values
+         *are computed in place in \member{thisIteration}, and are
+         *within \variable{evaluationError} of those of the policy
+         *(see the implementation file) when $\gamma < 1$. Otherwise
+         *the number of sweeps is bounded, as the values need not
+         *converge.*/
+        void evaluatePolicy();
+    private:
+        /*Number of states that are being iterated.*/
+        unsigned int numberOfStates()const;
+
+        /*Sequence of \class{eState}s that are being iterated.*/
+        vector<eState*> domainStates;
+
+        /*Index of states, for the purpoose of iteration.*/
+        map<eState*, int> stateIds;
+
+        /*System dynamics*/
+        CompressedDynamics dynamics;
+
+        /*Last iteration value function.*/
+        vector<double> lastIteration;
+
+        /*This iteration value function.*/
+        vector<double> thisIteration;
+
+        /*Initial reward.*/
+        vector<double> initialReward;
+
+        /*Choice of the \member{policy} for each state.*/
+        vector<unsigned int> choices;
+
+        /*Choice of each state after the last policy improvement, and
+         *whether that improvement altered the choice.*/
+        vector<unsigned int> improvedChoices;
+        vector<char> improved;
+
+        /*Number of iterations of this algorithm that have been
+         *executed.*/
+        int iteration;
+
+        /*Current policy, $0$ where the states are those of a
+         *\class{DomainImage}.*/
+        Policy* policy;
+
+        /*Next identification number to be given to a state.*/
+        int stateId;
+    };
+};
+
+#endif
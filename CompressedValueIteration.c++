@@ -0,0 +1,252 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include<cassert>
+#include<cmath>
+
+#include"CompressedValueIteration.h++"
+#include"domainSpecification_Anytime_or_Explicit.h++"
+
+CompressedValueIteration::CompressedValueIteration(DomainSpecification* domSpec)
+    : Algorithm(*domSpec),
+      epoch(0),
+      stateId(0)
+{
+    cerr<<"An attempt to execute explicit value iteration with a non--explicit domain will fail!\n";
+}
+
+CompressedValueIteration::CompressedValueIteration(explicitDomainSpecification& domSpec,
+                                                   double gamma,
+                                                   double epsilon,
+                                                   bool delayInitialisation)
+    : Algorithm(domSpec, gamma, epsilon),
+      epoch(0),
+      stateId(0)
+{
+    if(!delayInitialisation)
+    {
+        domainStates = domSpec.getStates(domainStates);
+
+        configurePolicy(domSpec);
+
+        identifyStates();
+
+        initialiseActions();
+
+        configureActions();
+
+        initialiseValueVectors();
+    }
+}
+
+CompressedValueIteration::CompressedValueIteration(explicitDomainSpecification& domSpec)
+    : Algorithm(domSpec),
+      epoch(0),
+      stateId(0)
+{
+    domainStates = domSpec.getStates(domainStates);
+
+    configurePolicy(domSpec);
+
+    identifyStates();
+
+    initialiseActions();
+
+    configureActions();
+
+    initialiseValueVectors();
+}
+
+CompressedValueIteration::CompressedValueIteration(const DomainImage& image,
+                                                   DomainSpecification& domSpec,
+                                                   double gamma,
+                                                   double epsilon)
+    : Algorithm(domSpec, gamma, epsilon),
+      epoch(0),
+      policy(0),
+      stateId(0)
+{
+    dynamics.view(image);
+
+    initialiseValueVectors(image);
+}
+
+void CompressedValueIteration::configurePolicy(explicitDomainSpecification& domSpec)
+{
+    policy = domSpec.getPolicy();
+}
+
+void CompressedValueIteration::initialiseValueVectors()
+{
+    lastEpoch = vector<double>(domainStates.size(), 0.0);
+
+    thisEpoch = vector<double>(domainStates.size(), 0.0);
+
+    initialReward = vector<double>(domainStates.size(), 0.0);
+
+    choices = vector<unsigned int>(domainStates.size(), CompressedDynamics::noChoice);
+
+    bestChoices = vector<unsigned int>(domainStates.size(), CompressedDynamics::noChoice);
+
+    for(vector<eState*>::const_iterator domainState = domainStates.begin()
+            ; domainState != domainStates.end()
+            ; ++domainState)
+    {
+        int id = stateIds[*domainState];
+
+        /*If the state is expanded then all transitional information
+          has been removed and the value associated with that state is
+          the expected reward.*/
+        if(FRINGE == (*domainState)->getColour()
+           || IMPLICIT == (*domainState)->getColour())
+            initialReward[id] = (*domainState)->getValue();
+        else
+            initialReward[id] = (*domainState)->getReward();
+
+        lastEpoch[id] = initialReward[id];
+    }
+}
+
+void CompressedValueIteration::initialiseValueVectors(const DomainImage& image)
+{
+    unsigned int states = image.numberOfStates();
+
+    lastEpoch = vector<double>(states, 0.0);
+
+    thisEpoch = vector<double>(states, 0.0);
+
+    initialReward = vector<double>(states, 0.0);
+
+    choices = vector<unsigned int>(states, CompressedDynamics::noChoice);
+
+    bestChoices = vector<unsigned int>(states, CompressedDynamics::noChoice);
+
+    for(unsigned int id = 0; id < states; ++id)
+    {
+        /*As for the states of a domain, see above.*/
+        if(FRINGE == image.getColour(id) || IMPLICIT == image.getColour(id))
+            initialReward[id] = image.getValue(id);
+        else
+            initialReward[id] = image.getReward(id);
+
+        lastEpoch[id] = initialReward[id];
+
+        choices[id] = image.getPolicyChoice(id);
+    }
+}
+
+void CompressedValueIteration::configureActions(bool ignoreExplicit)
+{
+    configureActions(domainStates.begin(), ignoreExplicit);
+}
+
+void CompressedValueIteration::configureActions(vector<eState*>::const_iterator domainState, bool ignoreExplicit)
+{
+    /*Rows are appended, thus the states must be configured in order
+      of identity.*/
+    assert(domainState == domainStates.end()
+           || static_cast<int>(dynamics.numberOfStates()) == stateIds[*domainState]);
+
+    for(; domainState != domainStates.end(); ++domainState)
+        dynamics.addState(*domainState,
+                          stateIds,
+                          !ignoreExplicit && EXPLICIT != (*domainState)->getColour());
+}
+
+void CompressedValueIteration::identifyStates()
+{
+    stateId = 0;
+    identifyStates(domainStates.begin());
+}
+
+void CompressedValueIteration::identifyStates(vector<eState*>::const_iterator domainState)
+{
+    /*Make the states identifiable.*/
+    for(; domainState != domainStates.end()
+            ; ++domainState, ++stateId)
+        stateIds[*domainState] = stateId;
+}
+
+void CompressedValueIteration::initialiseActions()
+{
+    dynamics.clear();
+    dynamics.setActions(*domSpec->getActionSpecification());
+}
+
+void CompressedValueIteration::updateStateValues()
+{
+    for(unsigned int i = 0; i < domainStates.size(); ++i)
+        domainStates[i]->setValue(thisEpoch[i]);
+}
+
+bool CompressedValueIteration::terminate(const vector<double>& thisEpoch,
+                                         const vector<double>& lastEpoch)
+{
+    double norm = CompressedDynamics::difference(thisEpoch, lastEpoch);
+
+    Algorithm::error = norm;
+
+    return (norm <= (epsilon * ((1 - gamma)/(2*gamma))));
+}
+
+unsigned int CompressedValueIteration::numberOfStates()const
+{
+    return dynamics.isView() ? dynamics.numberOfStates() : domainStates.size();
+}
+
+const vector<double>& CompressedValueIteration::getValues()const
+{
+    return thisEpoch;
+}
+
+const vector<unsigned int>& CompressedValueIteration::getChoices()const
+{
+    return choices;
+}
+
+bool CompressedValueIteration::operator()()
+{
+    epoch++;
+
+    if(0 == numberOfStates())
+        return terminate(thisEpoch, lastEpoch);
+
+    /*Fused backup, for each state the best of all its actions. The
+      states are backed up concurrently, the policy is written after.*/
+    dynamics.backupStates(&lastEpoch[0], gamma, thisEpoch, bestChoices);
+
+    for(unsigned int j = 0; j < numberOfStates(); ++j)
+    {
+        unsigned int choice = bestChoices[j];
+
+        /*Was some action superior for this state?*/
+        if(CompressedDynamics::noChoice != choice && choice != choices[j])
+        {
+            if(0 != policy)
+                (*policy)[domainStates[j]] = dynamics.getAction(choice);
+            choices[j] = choice;
+        }
+
+        thisEpoch[j] += initialReward[j];
+    }
+
+    bool doTerminate = terminate(thisEpoch, lastEpoch);
+
+    lastEpoch = thisEpoch;
+
+    return doTerminate;
+}
@@ -0,0 +1,187 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+/*
+ * \paragraph{:Purpose:}
+ *
+ * Value iteration over \class{CompressedDynamics}. This computes the
+ * same value function and policy as \class{ValueIteration}, however
+ * each epoch is a single pass over the states in which the backup of
+ * every action is fused, rather than one sparse matrix product per
+ * action.
+ * */
+#ifndef COMPRESSED_VALUE_ITERATION
+#define COMPRESSED_VALUE_ITERATION
+
+#include "Algorithm.h++"
+#include "CompressedDynamics.h++"
+#include "DomainImage.h++"
+
+using namespace std;
+
+namespace MDP
+{
+    class CompressedValueIteration : public Algorithm
+    {
+    public:
+        /*Value iteration can be used as the dynamic programming step
+         *in \class{LAO}.*/
+        friend class LAO<CompressedValueIteration>;
+
+        /*A call to this constructor results in erroneous behaviour as
+         *this is a state based algorithm (ie: requires an
+         *\class{explicitDomainSpecification}).*/
+        CompressedValueIteration(DomainSpecification* domSpec);
+
+        /*Construct the algorithmic object with \argument{domSpec} as
+         *the specification on which the algorithms is to be executed,
+         *\argument{gamma} the discount factor and \argument{epsilon}
+         *the acceptable error.
+         *
+         *A client who desires finer grained control over the
+         *configuration of this \class{Algorithm} should pass an
+         *\argument{delayInitialisation} value of $true$.*/
+        CompressedValueIteration(explicitDomainSpecification& domSpec,
+                                 double gamma,
+                                 double epsilon,
+                                 bool delayInitialisation = false);
+
+        /*Construct the algorithmic object with \argument{domSpec} as
+         *the specification on which the algorithms is to be
+         *executed. Discounting and error is taken to be the defaults
+         *provided by the \parent{Algorithm}.*/
+        CompressedValueIteration(explicitDomainSpecification& domSpec);
+
+        /*Construct the algorithmic object over the states of the
+         *argument \class{DomainImage}, which must remain open while
+         *this algorithm is in use. The rows of the image are not
+         *copied (see \method{CompressedDynamics.view()}). There are no
+         *\class{eState}s, thus the policy is that given by
+         *\method{getChoices()}. The \argument{domSpec} is that of the
+         *\parent{Algorithm}.*/
+        CompressedValueIteration(const DomainImage& image,
+                                 DomainSpecification& domSpec,
+                                 double gamma,
+                                 double epsilon);
+
+        /*Set the algorithm policy to that of the
+         *\argument{explicitDomainSpecification}*/
+        void configurePolicy(explicitDomainSpecification&);
+
+        /*Initialise \member{lastEpoch} value to state values
+         *\member{State.getValue()} and \member{initialReward} to
+         *\member{domSpec} \class{State} immediate reward
+         *\member{State.getReward()}.
+         *
+         *This function also accommodates state colourings. If states
+         *are coloured as either FRINGE or IMPLICIT then the immediate
+         *reward is considered to be \member{State.getValue()}.*/
+        void initialiseValueVectors();
+
+        /*As \method{initialiseValueVectors()}, given the rewards,
+         *values, colours and policy of the argument image.*/
+        void initialiseValueVectors(const DomainImage&);
+
+        /*Append the rows of the states from \argument{domainState}
+         *onwards to the \member{dynamics}. The rows of the states
+         *before \argument{domainState} must already be present.
+         *
+         *Unless \argument{ignoreExplicit} is $true$ only EXPLICIT
+         *states have transitions, and only those to states in
+         *\member{stateIds}.*/
+        void configureActions(vector<eState*>::const_iterator domainState, bool ignoreExplicit = true);
+
+        /*Assigns integer identities to all the \member{domSpec}
+         *states. The resultant mapping from states an integers is
+         *available in \member{stateIds}*/
+        void identifyStates(vector<eState*>::const_iterator domainState);
+
+        /*See \member{configureActions}.*/
+        void configureActions(bool ignoreExplicit = true);
+
+        /*See \member{identifyStates}.*/
+        void identifyStates();
+
+        /*Empty the \member{dynamics} and set its actions to those of
+         *the domain.*/
+        void initialiseActions();
+
+        /*Update the value associated with elements of
+         *\member{domainStates} to include the n--epoch values
+         *resulting from the last iteration of this algorithm.*/
+        void updateStateValues();
+
+        /*Has this algorithm found a solution with suitable error? The
+         *arguments are the current and last epoch values
+         *respectively. \member{Algorithm::error} is updated when a
+         *call is made and is the greatest element of their
+         *difference, as for \class{ValueIteration}.*/
+        bool terminate(const vector<double>& thisEpoch, const vector<double>& lastEpoch);
+
+        /*Execute an iteration of this algorithm.*/
+        bool operator()();
+
+        /*Value of each state after the last iteration.*/
+        const vector<double>& getValues()const;
+
+        /*Choice (see \class{CompressedDynamics}) of the policy at each
+         *state, \member{CompressedDynamics::noChoice} where there is
+         *none.*/
+        const vector<unsigned int>& getChoices()const;
+    private:
+        /*Number of states that are being iterated.*/
+        unsigned int numberOfStates()const;
+
+        /*Sequence of \class{eState}s that are being iterated.*/
+        vector<eState*> domainStates;
+
+        /*Index of states, for the purpoose of iteration.*/
+        map<eState*, int> stateIds;
+
+        /*System dynamics*/
+        CompressedDynamics dynamics;
+
+        /*Last epoch value function.*/
+        vector<double> lastEpoch;
+
+        /*This epoch value function.*/
+        vector<double> thisEpoch;
+
+        /*Initial reward.*/
+        vector<double> initialReward;
+
+        /*Choice last written to the \member{policy} for each state,
+         *so that the \member{policy} is only written where it
+         *changes.*/
+        vector<unsigned int> choices;
+
+        /*Maximising choice of each state in the last epoch.*/
+        vector<unsigned int> bestChoices;
+
+        /*Epoch number.*/
+        int epoch;
+
+        /*Current policy, $0$ where the states are those of a
+         *\class{DomainImage}.*/
+        Policy* policy;
+
+        /*Next identification number to be given to a state.*/
+        int stateId;
+    };
+};
+
+#endif
@@ -0,0 +1,620 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include"DomainImage.h++"
+#include"CompressedDynamics.h++"
+
+#include"States.h++"
+#include"actionSpecification.h++"
+#include"rewardSpecification.h++"
+#include"domainSpecification_Anytime_or_Explicit.h++"
+
+#include<map>
+#include<cstring>
+#include<fstream>
+#include<sstream>
+#include<iostream>
+
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+
+using namespace MDP;
+
+const unsigned int DomainImage::version;
+const unsigned int DomainImage::noState;
+const unsigned int DomainImage::byteOrderMark;
+
+const char DomainImage::magic[8] = {'N', 'M', 'R', 'D', 'P', 'I', 'M', 'G'};
+
+/*Smallest multiple of eight that is no less than the argument.*/
+static unsigned long long align(unsigned long long offset)
+{
+    return (offset + 7) & ~7ULL;
+}
+
+/*Write \argument{bytes} from \argument{data} at \argument{offset},
+ *which is no less than the \argument{position} of the stream. The gap
+ *is filled with zeros.*/
+static void writeAt(ostream& out,
+                    unsigned long long& position,
+                    unsigned long long offset,
+                    const void* data,
+                    unsigned long long bytes)
+{
+    for(; position < offset; ++position)
+        out.put('\0');
+
+    if(0 != bytes)
+        out.write(static_cast<const char*>(data), bytes);
+
+    position += bytes;
+}
+
+/*Formulae of the reward label of the argument state separated by
+ *commas, as in \method{explicitDomainSpecification.policyToString()}.*/
+static string labelToString(const eState* state)
+{
+    ostringstream answer;
+
+    if(0 == state->getRewardSpecification())
+        return answer.str();
+
+    bool first = true;
+    for(RewardSpecification::const_iterator
+            reward = state->getRewardSpecification()->begin()
+            ; reward != state->getRewardSpecification()->end()
+            ; ++reward)
+    {
+        if(!first)
+            answer<<", ";
+        first = false;
+        string* tmp = reward->second.form->print();
+        answer<<*tmp;
+        delete tmp;
+    }
+
+    return answer.str();
+}
+
+        /*
+         *Construction
+         */
+
+DomainImage::DomainImage()
+    :mapping(0)
+{
+    close();
+}
+
+DomainImage::~DomainImage()
+{
+    close();
+}
+
+        /*
+         *Functionality
+         */
+
+unsigned long long DomainImage::sectionSize(const Header& header,
+                                            Section section,
+                                            unsigned long long strings)
+{
+    switch(section)
+    {
+    case stringOffsetSection:
+        return sizeof(unsigned int)
+            * (header.propositions + header.labels + header.actions + 1ULL);
+    case stringDataSection:
+        return strings;
+    case stateRecordSection:
+        return sizeof(StateRecord) * static_cast<unsigned long long>(header.states);
+    case propositionBitSection:
+        return sizeof(unsigned int) * static_cast<unsigned long long>(header.states) * header.words;
+    case stateOffsetSection:
+        return sizeof(unsigned int) * (header.states + 1ULL);
+    case choiceActionSection:
+        return sizeof(unsigned int) * static_cast<unsigned long long>(header.choices);
+    case choiceOffsetSection:
+        return sizeof(unsigned int) * (header.choices + 1ULL);
+    case successorSection:
+        return sizeof(unsigned int) * static_cast<unsigned long long>(header.transitions);
+    case probabilitySection:
+        return sizeof(double) * static_cast<unsigned long long>(header.transitions);
+    case policyChoiceSection:
+        return sizeof(unsigned int) * static_cast<unsigned long long>(header.states);
+    default:
+        return 0;
+    }
+}
+
+void DomainImage::layout(Header& header, unsigned long long strings)
+{
+    unsigned long long offset = align(sizeof(Header));
+
+    for(unsigned int section = 0; section < numberOfSections; ++section)
+    {
+        header.sections[section] = offset;
+        offset = align(offset + sectionSize(header, static_cast<Section>(section), strings));
+    }
+
+    header.size = offset;
+}
+
+bool DomainImage::save(const string& filename, explicitDomainSpecification& domSpec)
+{
+    vector<eState*> states;
+    states = domSpec.getStates(states);
+
+    map<eState*, int> stateIds;
+    for(unsigned int i = 0; i < states.size(); ++i)
+        stateIds[states[i]] = i;
+
+    /*Every state has its row, as in the solution algorithms that are
+      not driven by search.*/
+    CompressedDynamics dynamics;
+    dynamics.setActions(*domSpec.getActionSpecification());
+    for(unsigned int i = 0; i < states.size(); ++i)
+        dynamics.addState(states[i], stateIds);
+
+    /*Propositions are numbered in order.*/
+    map<string, unsigned int> propositionIds;
+    for(unsigned int i = 0; i < states.size(); ++i)
+        for(DomainSpecification::PropositionSet::const_iterator
+                proposition = states[i]->getPropositions().begin()
+                ; proposition != states[i]->getPropositions().end()
+                ; ++proposition)
+            propositionIds[*proposition] = 0;
+
+    vector<string> strings;
+    for(map<string, unsigned int>::iterator proposition = propositionIds.begin()
+            ; proposition != propositionIds.end()
+            ; ++proposition)
+    {
+        proposition->second = strings.size();
+        strings.push_back(proposition->first);
+    }
+
+    /*Labels are numbered in order of their first occurrence.*/
+    map<string, unsigned int> labelIds;
+    vector<string> labels;
+    vector<StateRecord> records(states.size());
+    for(unsigned int i = 0; i < states.size(); ++i)
+    {
+        string label = labelToString(states[i]);
+
+        map<string, unsigned int>::const_iterator labelId = labelIds.find(label);
+        if(labelIds.end() == labelId)
+        {
+            labelId = labelIds.insert(pair<string, unsigned int>
+                                      (label, labels.size())).first;
+            labels.push_back(label);
+        }
+
+        memset(&records[i], 0, sizeof(StateRecord));
+        records[i].reward = states[i]->getReward();
+        records[i].value = states[i]->getValue();
+        records[i].label = labelId->second;
+        records[i].colour = states[i]->getColour();
+        records[i].possible = states[i]->isPossible();
+    }
+
+    const vector<action>& actions = dynamics.getActions();
+    strings.insert(strings.end(), labels.begin(), labels.end());
+    strings.insert(strings.end(), actions.begin(), actions.end());
+
+    Header header;
+    memset(&header, 0, sizeof(Header));
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.byteOrder = byteOrderMark;
+    header.states = states.size();
+    header.propositions = propositionIds.size();
+    header.labels = labels.size();
+    header.actions = actions.size();
+    header.choices = dynamics.numberOfChoices();
+    header.transitions = dynamics.numberOfTransitions();
+    header.words = (header.propositions + 31) / 32;
+    header.startState = noState;
+
+    map<eState*, int>::const_iterator start = stateIds.find(domSpec.getStartState());
+    if(stateIds.end() != start)
+        header.startState = start->second;
+
+    /*String table, each string is followed by a null.*/
+    vector<unsigned int> stringOffsets;
+    string stringData;
+    for(vector<string>::const_iterator s = strings.begin(); s != strings.end(); ++s)
+    {
+        stringOffsets.push_back(stringData.size());
+        stringData += *s;
+        stringData += '\0';
+    }
+    stringOffsets.push_back(stringData.size());
+
+    vector<unsigned int> propositionBits(header.states * header.words, 0);
+    for(unsigned int i = 0; i < states.size(); ++i)
+        for(DomainSpecification::PropositionSet::const_iterator
+                proposition = states[i]->getPropositions().begin()
+                ; proposition != states[i]->getPropositions().end()
+                ; ++proposition)
+        {
+            unsigned int p = propositionIds[*proposition];
+            propositionBits[i * header.words + p / 32] |= 1U << (p % 32);
+        }
+
+    /*Choices of the domain policy.*/
+    vector<unsigned int> policyChoices(states.size(), CompressedDynamics::noChoice);
+    Policy* policy = domSpec.getPolicy();
+    for(unsigned int i = 0; i < states.size(); ++i)
+    {
+        Policy::const_iterator act = policy->find(states[i]);
+
+        if(policy->end() != act)
+            policyChoices[i] = dynamics.findChoice(i, act->second);
+    }
+
+    vector<unsigned int> stateOffsets, choiceActions, choiceOffsets, successors;
+    vector<double> probabilities;
+    stateOffsets.push_back(0);
+    choiceOffsets.push_back(0);
+    for(unsigned int i = 0; i < states.size(); ++i)
+    {
+        for(unsigned int choice = dynamics.beginChoice(i)
+                ; choice != dynamics.endChoice(i)
+                ; ++choice)
+        {
+            for(unsigned int entry = dynamics.beginSuccessor(choice)
+                    ; entry != dynamics.endSuccessor(choice)
+                    ; ++entry)
+            {
+                successors.push_back(dynamics.getSuccessor(entry));
+                probabilities.push_back(dynamics.getProbability(entry));
+            }
+
+            choiceActions.push_back(dynamics.getActionId(choice));
+            choiceOffsets.push_back(successors.size());
+        }
+
+        stateOffsets.push_back(choiceActions.size());
+    }
+
+    layout(header, stringData.size());
+
+    ofstream out(filename.c_str(), ios::out | ios::binary | ios::trunc);
+
+    if(!out)
+        return false;
+
+    unsigned long long position = 0;
+    writeAt(out, position, 0, &header, sizeof(Header));
+    writeAt(out, position, header.sections[stringOffsetSection],
+            &stringOffsets[0], sizeof(unsigned int) * stringOffsets.size());
+    writeAt(out, position, header.sections[stringDataSection],
+            stringData.data(), stringData.size());
+    writeAt(out, position, header.sections[stateRecordSection],
+            records.empty() ? 0 : &records[0], sizeof(StateRecord) * records.size());
+    writeAt(out, position, header.sections[propositionBitSection],
+            propositionBits.empty() ? 0 : &propositionBits[0],
+            sizeof(unsigned int) * propositionBits.size());
+    writeAt(out, position, header.sections[stateOffsetSection],
+            &stateOffsets[0], sizeof(unsigned int) * stateOffsets.size());
+    writeAt(out, position, header.sections[choiceActionSection],
+            choiceActions.empty() ? 0 : &choiceActions[0],
+            sizeof(unsigned int) * choiceActions.size());
+    writeAt(out, position, header.sections[choiceOffsetSection],
+            &choiceOffsets[0], sizeof(unsigned int) * choiceOffsets.size());
+    writeAt(out, position, header.sections[successorSection],
+            successors.empty() ? 0 : &successors[0],
+            sizeof(unsigned int) * successors.size());
+    writeAt(out, position, header.sections[probabilitySection],
+            probabilities.empty() ? 0 : &probabilities[0],
+            sizeof(double) * probabilities.size());
+    writeAt(out, position, header.sections[policyChoiceSection],
+            policyChoices.empty() ? 0 : &policyChoices[0],
+            sizeof(unsigned int) * policyChoices.size());
+    writeAt(out, position, header.size, 0, 0);
+
+    return !out.fail();
+}
+
+bool DomainImage::save(const string& filename,
+                       const vector<double>& values,
+                       const vector<unsigned int>& choices)const
+{
+    if(!isOpen()
+       || values.size() != numberOfStates()
+       || choices.size() != numberOfStates())
+        return false;
+
+    /*The image is copied, only the values and choices differ.*/
+    vector<char> image(mapping, mapping + header->size);
+
+    StateRecord* records
+        = reinterpret_cast<StateRecord*>(&image[header->sections[stateRecordSection]]);
+    unsigned int* policy
+        = reinterpret_cast<unsigned int*>(&image[header->sections[policyChoiceSection]]);
+
+    for(unsigned int i = 0; i < numberOfStates(); ++i)
+    {
+        records[i].value = values[i];
+        policy[i] = choices[i];
+    }
+
+    ofstream out(filename.c_str(), ios::out | ios::binary | ios::trunc);
+
+    if(!out)
+        return false;
+
+    out.write(&image[0], image.size());
+
+    return !out.fail();
+}
+
+bool DomainImage::open(const string& filename)
+{
+    close();
+
+    int file = ::open(filename.c_str(), O_RDONLY);
+
+    if(-1 == file)
+    {
+        cerr<<"The domain image \""<<filename<<"\" could not be opened.\n";
+        return false;
+    }
+
+    struct stat status;
+    if(0 != fstat(file, &status) || static_cast<unsigned long long>(status.st_size) < sizeof(Header))
+    {
+        cerr<<"The file \""<<filename<<"\" is not a domain image.\n";
+        ::close(file);
+        return false;
+    }
+
+    void* map = mmap(0, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+    /*The mapping remains valid once the file is closed.*/
+    ::close(file);
+
+    if(MAP_FAILED == map)
+    {
+        cerr<<"The domain image \""<<filename<<"\" could not be mapped.\n";
+        return false;
+    }
+
+    mapping = static_cast<const char*>(map);
+    mappedSize = status.st_size;
+    header = reinterpret_cast<const Header*>(mapping);
+
+    string problem;
+    if(0 != memcmp(header->magic, magic, sizeof(magic)))
+        problem = "is not a domain image";
+    else if(byteOrderMark != header->byteOrder)
+        problem = "was written with another byte order";
+    else if(version != header->version)
+        problem = "is of another version";
+    else if(mappedSize != header->size)
+        problem = "is truncated";
+    else
+    {
+        /*Sections are aligned, in order and within the file.*/
+        unsigned long long end = sizeof(Header);
+        for(unsigned int section = 0; section < numberOfSections && problem.empty(); ++section)
+        {
+            unsigned long long strings = 0;
+
+            /*The size of the string data is the last string offset.*/
+            if(stringDataSection == section)
+                strings = reinterpret_cast<const unsigned int*>
+                    (mapping + header->sections[stringOffsetSection])
+                    [header->propositions + header->labels + header->actions];
+
+            if(0 != header->sections[section] % 8
+               || header->sections[section] < end
+               || header->sections[section] > mappedSize
+               || sectionSize(*header, static_cast<Section>(section), strings)
+               > mappedSize - header->sections[section])
+                problem = "is corrupt";
+            else
+                end = header->sections[section]
+                    + sectionSize(*header, static_cast<Section>(section), strings);
+        }
+    }
+
+    if(problem.empty())
+    {
+        locateSections();
+
+        if(header->words != (header->propositions + 31) / 32
+           || (noState != header->startState && header->startState >= header->states)
+           || !isConsistent())
+            problem = "is corrupt";
+    }
+
+    if(!problem.empty())
+    {
+        cerr<<"The file \""<<filename<<"\" "<<problem<<".\n";
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void DomainImage::locateSections()
+{
+    const unsigned long long* sections = header->sections;
+
+    stringOffsets = reinterpret_cast<const unsigned int*>(mapping + sections[stringOffsetSection]);
+    stringData = mapping + sections[stringDataSection];
+    stateRecords = reinterpret_cast<const StateRecord*>(mapping + sections[stateRecordSection]);
+    propositionBits = reinterpret_cast<const unsigned int*>(mapping + sections[propositionBitSection]);
+    stateOffsets = reinterpret_cast<const unsigned int*>(mapping + sections[stateOffsetSection]);
+    choiceActions = reinterpret_cast<const unsigned int*>(mapping + sections[choiceActionSection]);
+    choiceOffsets = reinterpret_cast<const unsigned int*>(mapping + sections[choiceOffsetSection]);
+    successors = reinterpret_cast<const unsigned int*>(mapping + sections[successorSection]);
+    probabilities = reinterpret_cast<const double*>(mapping + sections[probabilitySection]);
+    policyChoices = reinterpret_cast<const unsigned int*>(mapping + sections[policyChoiceSection]);
+}
+
+/*Is each element of the argument array of \argument{size} elements
+ *no less than the one before it?*/
+static bool isMonotonic(const unsigned int* array, unsigned long long size)
+{
+    for(unsigned long long i = 1; i < size; ++i)
+        if(array[i] < array[i - 1])
+            return false;
+
+    return true;
+}
+
+bool DomainImage::isConsistent()const
+{
+    unsigned long long strings = header->propositions + header->labels + header->actions;
+
+    /*Every string begins within the string data, which ends with a
+      null.*/
+    if(!isMonotonic(stringOffsets, strings + 1)
+       || (0 != strings && stringOffsets[strings - 1] >= stringOffsets[strings])
+       || (0 != stringOffsets[strings] && '\0' != stringData[stringOffsets[strings] - 1]))
+        return false;
+
+    if(0 != stateOffsets[0]
+       || header->choices != stateOffsets[header->states]
+       || !isMonotonic(stateOffsets, header->states + 1ULL)
+       || 0 != choiceOffsets[0]
+       || header->transitions != choiceOffsets[header->choices]
+       || !isMonotonic(choiceOffsets, header->choices + 1ULL))
+        return false;
+
+    for(unsigned int choice = 0; choice < header->choices; ++choice)
+        if(choiceActions[choice] >= header->actions)
+            return false;
+
+    for(unsigned int entry = 0; entry < header->transitions; ++entry)
+        if(successors[entry] >= header->states)
+            return false;
+
+    /*A policy choice is one of the choices of its state.*/
+    for(unsigned int state = 0; state < header->states; ++state)
+        if(stateRecords[state].label >= header->labels
+           || (CompressedDynamics::noChoice != policyChoices[state]
+               && (policyChoices[state] < stateOffsets[state]
+                   || policyChoices[state] >= stateOffsets[state + 1])))
+            return false;
+
+    return true;
+}
+
+void DomainImage::close()
+{
+    if(0 != mapping)
+        munmap(const_cast<char*>(mapping), mappedSize);
+
+    mapping = 0;
+    mappedSize = 0;
+    header = 0;
+    stringOffsets = 0;
+    stringData = 0;
+    stateRecords = 0;
+    propositionBits = 0;
+    stateOffsets = 0;
+    choiceActions = 0;
+    choiceOffsets = 0;
+    successors = 0;
+    probabilities = 0;
+    policyChoices = 0;
+}
+
+        /*
+         *Queries + Accessors
+         */
+
+bool DomainImage::isOpen()const
+{
+    return 0 != mapping;
+}
+
+unsigned int DomainImage::numberOfStates()const
+{
+    return isOpen() ? header->states : 0;
+}
+
+unsigned int DomainImage::numberOfChoices()const
+{
+    return isOpen() ? header->choices : 0;
+}
+
+unsigned int DomainImage::numberOfTransitions()const
+{
+    return isOpen() ? header->transitions : 0;
+}
+
+unsigned int DomainImage::numberOfActions()const
+{
+    return isOpen() ? header->actions : 0;
+}
+
+const char* DomainImage::getAction(unsigned int a)const
+{
+    return stringData + stringOffsets[header->propositions + header->labels + a];
+}
+
+unsigned int DomainImage::getStartState()const
+{
+    return isOpen() ? header->startState : noState;
+}
+
+const char* DomainImage::getLabel(unsigned int state)const
+{
+    return stringData + stringOffsets[header->propositions + stateRecords[state].label];
+}
+
+string DomainImage::propositionsToString(unsigned int state)const
+{
+    string answer;
+
+    const unsigned int* bits = propositionBits + state * static_cast<unsigned long long>(header->words);
+
+    for(unsigned int p = 0; p < header->propositions; ++p)
+        if(bits[p / 32] & (1U << (p % 32)))
+        {
+            if(!answer.empty())
+                answer += ", ";
+            answer += stringData + stringOffsets[p];
+        }
+
+    return answer;
+}
+
+string DomainImage::policyToString(const vector<unsigned int>& choices)const
+{
+    ostringstream answer;
+
+    for(unsigned int i = 0; i < choices.size() && i < numberOfStates(); ++i)
+        if(CompressedDynamics::noChoice != choices[i])
+            answer<<"({"<<propositionsToString(i)<<"}, {"<<getLabel(i)<<"}) |-> "
+                  <<getAction(choiceActions[choices[i]])<<endl;
+
+    return answer.str();
+}
+
+unsigned long long DomainImage::memory()const
+{
+    return mappedSize;
+}
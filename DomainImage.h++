@@ -0,0 +1,284 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+/*
+ * \paragraph{:Purpose:}
+ *
+ * Binary image of an expanded domain, so that a state space need
+ * only be expanded once. The image holds, for every state of an
+ * \class{explicitDomainSpecification}, its propositions, the text of
+ * its reward label, its reward, value, colour and policy choice, and
+ * the dynamics of the domain in the compressed sparse rows of
+ * \class{CompressedDynamics}.
+ *
+ * An image is read by mapping the file into memory. Nothing is
+ * copied or parsed when an image is opened. The arrays are checked
+ * once, so that every offset is monotonic and every index is within
+ * its bounds, and are then used without checks. The rows of the
+ * image are used in place by \class{CompressedValueIteration} and
+ * \class{CompressedPolicyIteration} (see
+ * \method{CompressedDynamics.view()}).
+ *
+ * The file is a header followed by sections, each starting at a
+ * multiple of eight bytes:
+ *
+ * \begin{enumerate}
+ *
+ * \item Offsets into the string data of every proposition, label and
+ * action name, in that order. Strings are interned, each label text
+ * occurs only once however many states share it.
+ *
+ * \item The string data, each string terminated by a null.
+ *
+ * \item A \class{DomainImage::StateRecord} per state.
+ *
+ * \item Proposition bits, \member{Header.words} words per state.
+ *
+ * \item The five arrays of \class{CompressedDynamics}.
+ *
+ * \item The policy choice of each state.
+ *
+ * \end{enumerate}
+ *
+ * Numbers are in the byte order of the machine that wrote the
+ * image. An image written with another byte order, or another
+ * \member{version}, is refused.
+ * */
+#ifndef DOMAIN_IMAGE
+#define DOMAIN_IMAGE
+
+#include"SpecificationTypes.h++"
+
+#include<string>
+#include<vector>
+
+using namespace std;
+
+namespace MDP
+{
+    class DomainImage
+    {
+    public:
+        /*Version of the format written. Any change to the layout of
+         *the file must change this.*/
+        static const unsigned int version = 1;
+
+        /*Construction of an image that is not open.*/
+        DomainImage();
+
+        /*The file is unmapped.*/
+        ~DomainImage();
+
+        /*Write the image of \argument{domSpec} to the file
+         *\argument{filename}. The values written are those of the
+         *states, thus a client should first update the states from
+         *its solution algorithm. Returns $false$ if the file could not
+         *be written.*/
+        static bool save(const string& filename, explicitDomainSpecification& domSpec);
+
+        /*Write a copy of this image to the file \argument{filename}
+         *with the state \argument{values} and policy
+         *\argument{choices} replaced, both have an element per
+         *state. Returns $false$ if the file could not be written.*/
+        bool save(const string& filename,
+                  const vector<double>& values,
+                  const vector<unsigned int>& choices)const;
+
+        /*Map the image in the file \argument{filename}, the image
+         *previously open is closed. Returns $false$, after reporting
+         *why, if the file is not a valid image.*/
+        bool open(const string& filename);
+
+        /*Unmap the image.*/
+        void close();
+
+        /*Is an image mapped?*/
+        bool isOpen()const;
+
+        /*Number of states of the image.*/
+        unsigned int numberOfStates()const;
+
+        /*Number of choices over all the states.*/
+        unsigned int numberOfChoices()const;
+
+        /*Number of successor entries over all the choices.*/
+        unsigned int numberOfTransitions()const;
+
+        /*Number of actions that choices may refer to.*/
+        unsigned int numberOfActions()const;
+
+        /*Name of the argument action.*/
+        const char* getAction(unsigned int)const;
+
+        /*Identifier of the start state, \member{noState} if the domain
+         *had none.*/
+        unsigned int getStartState()const;
+
+        /*Immediate reward of the argument state.*/
+        double getReward(unsigned int state)const
+            {return stateRecords[state].reward;}
+
+        /*Value of the argument state when the image was written.*/
+        double getValue(unsigned int state)const
+            {return stateRecords[state].value;}
+
+        /*Colour (see \member{State.getColour()}) of the argument
+         *state.*/
+        int getColour(unsigned int state)const
+            {return stateRecords[state].colour;}
+
+        /*Is the argument state possible?*/
+        bool isPossible(unsigned int state)const
+            {return 0 != stateRecords[state].possible;}
+
+        /*Choice of the policy at the argument state, or
+         *\member{CompressedDynamics::noChoice}.*/
+        unsigned int getPolicyChoice(unsigned int state)const
+            {return policyChoices[state];}
+
+        /*Text of the reward label of the argument state, as the
+         *formulae of the label separated by commas.*/
+        const char* getLabel(unsigned int state)const;
+
+        /*Propositions of the argument state, separated by commas.*/
+        string propositionsToString(unsigned int state)const;
+
+        /*The policy given by \argument{choices}, one per state, in the
+         *format of \method{explicitDomainSpecification.policyToString()}.*/
+        string policyToString(const vector<unsigned int>& choices)const;
+
+        /*The arrays of \class{CompressedDynamics} (see
+         *\method{CompressedDynamics.view()}).*/
+        const unsigned int* getStateOffsets()const{return stateOffsets;}
+        const unsigned int* getChoiceActions()const{return choiceActions;}
+        const unsigned int* getChoiceOffsets()const{return choiceOffsets;}
+        const unsigned int* getSuccessors()const{return successors;}
+        const double* getProbabilities()const{return probabilities;}
+
+        /*Number of bytes of the mapped file.*/
+        unsigned long long memory()const;
+
+        /*Identifier of the absence of a state.*/
+        static const unsigned int noState = ~0U;
+    private:
+        /*Sections of the file in order.*/
+        enum Section
+        {
+            stringOffsetSection,
+            stringDataSection,
+            stateRecordSection,
+            propositionBitSection,
+            stateOffsetSection,
+            choiceActionSection,
+            choiceOffsetSection,
+            successorSection,
+            probabilitySection,
+            policyChoiceSection,
+            numberOfSections
+        };
+
+        /*First bytes of the file.*/
+        struct Header
+        {
+            char magic[8];
+            unsigned int version;
+
+            /*\member{byteOrderMark} as written by the machine that
+             *wrote the image.*/
+            unsigned int byteOrder;
+
+            unsigned int states;
+            unsigned int propositions;
+            unsigned int labels;
+            unsigned int actions;
+            unsigned int choices;
+            unsigned int transitions;
+
+            /*Number of words of proposition bits per state.*/
+            unsigned int words;
+
+            unsigned int startState;
+
+            /*Size of the whole file.*/
+            unsigned long long size;
+
+            /*Offset from the start of the file of each section.*/
+            unsigned long long sections[numberOfSections];
+        };
+
+        /*Scalar attributes of a state.*/
+        struct StateRecord
+        {
+            double reward;
+            double value;
+
+            /*Index of the label among the labels of the string
+             *table.*/
+            unsigned int label;
+
+            int colour;
+            unsigned int possible;
+            unsigned int padding;
+        };
+
+        static const char magic[8];
+
+        static const unsigned int byteOrderMark = 0x01020304;
+
+        /*Number of bytes of the argument section given the counts of
+         *the \argument{header}.*/
+        static unsigned long long sectionSize(const Header& header, Section,
+                                              unsigned long long strings);
+
+        /*Set the \member{sections} and \member{size} of the
+         *\argument{header}, given \argument{strings} bytes of string
+         *data.*/
+        static void layout(Header& header, unsigned long long strings);
+
+        /*Set the section pointers of this image from the mapping.*/
+        void locateSections();
+
+        /*Are the offsets of the located sections monotonic and their
+         *indices within bounds? The sections must be within the
+         *mapping.*/
+        bool isConsistent()const;
+
+        /*Mapped file, $0$ if no image is open.*/
+        const char* mapping;
+
+        /*Number of bytes of the \member{mapping}.*/
+        unsigned long long mappedSize;
+
+        const Header* header;
+        const unsigned int* stringOffsets;
+        const char* stringData;
+        const StateRecord* stateRecords;
+        const unsigned int* propositionBits;
+        const unsigned int* stateOffsets;
+        const unsigned int* choiceActions;
+        const unsigned int* choiceOffsets;
+        const unsigned int* successors;
+        const double* probabilities;
+        const unsigned int* policyChoices;
+
+        /*Ensure that a \class{DomainImage} cannot be copied.*/
+        DomainImage(const DomainImage&);
+        DomainImage& operator=(const DomainImage&);
+    };
+}
+
+#endif
@@ -15,6 +15,8 @@
 // License along with this library; if not, write to the Free Software
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
+#include<sstream>
+
 #include"EntailmentFilter.h++"
 #include"rewardSpecification.h++"
 #include"formula.h++"
@@ -34,6 +36,29 @@ formula* EntailmentFilter::operator()(formula* form, bool lastChance)const
     return form;
 }
 
+bool EntailmentFilter::signature(string& sig)const
+{
+    FormulaTable* formulaTable = FormulaTable::getInstance();
+
+    /*The formulae of the specification are identified by their
+      canonical nodes, thus a table is required.*/
+    if(0 == formulaTable)
+        return false;
+    
+    ostringstream answer;
+    answer<<"entailment:";
+    if(0 != rewardSpecification)
+        for(RewardSpecification::const_iterator element = rewardSpecification->begin()
+                ; element != rewardSpecification->end()
+                ; ++element)
+            answer<<element->first<<'\0'
+                  <<formulaTable->intern(element->second.form)->getNodeId()<<';';
+
+    sig = answer.str();
+    
+    return true;
+}
+
 formula* EntailmentFilter::applyFilter(formula* form) const
 {
     string* formStr;
@@ -86,6 +111,16 @@ formula* MinimalEntailmentFilter::operator()(formula* form, bool lastChance)cons
     return applyFilter(form);
 }
 
+bool MinimalEntailmentFilter::signature(string& sig)const
+{
+    if(!EntailmentFilter::signature(sig))
+        return false;
+    
+    sig = "minimal " + sig;
+    
+    return true;
+}
+
 /****************************************************/
 ZeroPredecessor::ZeroPredecessor()
     :EntailmentFilter(0)
@@ -133,3 +168,9 @@ formula* ZeroPredecessor::operator()(formula* form, bool lastChance)const
     return form;
 }
 
+bool ZeroPredecessor::signature(string& sig)const
+{
+    sig = "zero predecessor";
+    
+    return true;
+}
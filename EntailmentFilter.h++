@@ -51,6 +51,12 @@ namespace MDP
          *
          *The \argument{form} is deleted on translation.*/
         formula* operator()(formula* form, bool lastChance = false)const;
+
+        /*The filter is described by the labels of the
+         *\member{rewardSpecification} and the canonical nodes of its
+         *formulae in the current \class{FormulaTable}. Without a
+         *table the filter can not be described.*/
+        bool signature(string&)const;
     protected:
         /*This is called by \method{operator()} when the filter is
          *deemed applicable. Filters may distinguish between
@@ -75,6 +81,9 @@ namespace MDP
          *
          *The \argument{form} is deleted on translation.*/
         formula* operator()(formula* form, bool lastChance = false)const;
+
+        /*See \parent{EntailmentFilter::signature()}.*/
+        bool signature(string&)const;
     };
     
     /*An entailment filter for a starting state such as
@@ -93,6 +102,9 @@ namespace MDP
          *
          *The \argument{form} is deleted on translation.*/
         formula* operator()(formula* form, bool lastChance = false)const;
+
+        /*This filter does not depend on a specification.*/
+        bool signature(string&)const;
     };
 }
 #endif
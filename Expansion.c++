@@ -18,9 +18,53 @@
 #include"Expansion.h++"
 
 #include"EntailmentFilter.h++"
+#include"WorkerPool.h++"
+#include"Instrumentation.h++"
+#include"formulaHashConsing.h++"
 
 using namespace MDP;
 
+/*Least number of successors whose rewards are calculated by one
+  thread.*/
+static const unsigned int rewardGrain = 4;
+
+/******************************************************************/
+
+class Expansion::RewardTask : public ParallelTask
+{
+public:
+    RewardTask(const Expansion& expansion,
+               const vector<State*>& successors,
+               const StateLabelling& nmrsLabels)
+        :expansion(expansion),
+         successors(successors),
+         nmrsLabels(nmrsLabels),
+         formulaTable(FormulaTable::getInstance()),
+         arena(Arena::getCurrent())
+    {}
+
+    void operator()(unsigned int begin, unsigned int end, unsigned int block)
+    {
+        /*The workers share the formulae and the arena of the
+          expanding thread.*/
+        FormulaTableScope formulaTableScope(formulaTable);
+        ArenaScope arenaScope(arena);
+        
+        for(unsigned int i = begin; i != end; ++i)
+            expansion.adjustState(successors[i], nmrsLabels);
+    }
+private:
+    const Expansion& expansion;
+    const vector<State*>& successors;
+    const StateLabelling& nmrsLabels;
+
+    /*Table current in the thread that expands the state.*/
+    FormulaTable* formulaTable;
+
+    /*Arena current in the thread that expands the state.*/
+    Arena* arena;
+};
+
 /******************************************************************/
 
 bool ZeroProbability::operator()(const TransitionPair& pair) const
@@ -173,8 +217,12 @@ double Expansion::getProbability(DdNode const* node,
     return result;
 }
 
-void Expansion::adjustStates(ActionPossibilities& actions,
-                             const StateLabelling& nmrsLabels) const
+void Expansion::labelStates(ActionPossibilities& actions,
+                            const StateLabelling& nmrsLabels) const
+{}
+
+void Expansion::adjustState(State* state,
+                            const StateLabelling& nmrsLabels) const
 {}
 
 StateTransitionMatrices* Expansion::operator()
@@ -182,6 +230,8 @@ StateTransitionMatrices* Expansion::operator()
      DomainSpecification& domSpec,
      const StateLabelling& nmrsLabels) const
 {
+    ScopedTimer timer(Instrumentation::successorGeneration);
+
     /*Handle to \argument{domSpec} \class{ActionSpecification}.*/
     ActionSpecification* asp = domSpec.getActionSpecification();
 
@@ -203,6 +253,9 @@ StateTransitionMatrices* Expansion::operator()
 
     /*The \argument{state} is the last state to be expanded.*/
     stateLastToExpand = &state;
+
+    /*Successor states of all the actions, in order of generation.*/
+    vector<State*> successors;
     
     /*For each $action$.*/
     for(ActionSpecification::caIterator action = asp->begin()
@@ -253,45 +306,60 @@ StateTransitionMatrices* Expansion::operator()
 
         produceTransitions(domSpec, probabilities, actions);
 
-        /*see \method{adjustStates()}*/
-        adjustStates(actions, nmrsLabels);
+        /*see \method{labelStates()}*/
+        labelStates(actions, nmrsLabels);
+
+        for(ActionPossibilities::const_iterator act = actions.begin()
+                ; act != actions.end()
+                ; ++act)
+            successors.push_back(act->second);
         
         (*stms)[action->first] = actions;  
     }
 
+    /*see \method{adjustState()}*/
+    RewardTask rewardTask(*this, successors, nmrsLabels);
+    WorkerPool::getInstance()->run(rewardTask, successors.size(), rewardGrain);
+
     return stms;
 }
 
 
 /******************************************************************/
 
-void StateAnnotationExpansion::adjustStates(ActionPossibilities& actions,
-                                            const StateLabelling& nmrsLabels) const
+void StateAnnotationExpansion::labelStates(ActionPossibilities& actions,
+                                           const StateLabelling& nmrsLabels) const
 {   
-    /*Calculate and adjust the reward specifications of the states.*/
-    for(ActionPossibilities::iterator act = actions.begin()
-            ; act != actions.end()
-            ; ++act)
+    /*If we are going for a minimised state space.*/
+    if(0 != nmrsLabels.size())
+        for(ActionPossibilities::iterator act = actions.begin()
+                ; act != actions.end()
+                ; ++act)
         {
-            /*If we are going for a minimised state space.*/
-            if(0 != nmrsLabels.size())
-                {
-                    const DomainSpecification::PropositionSet& some
-                        = act->second->getPropositions();
+            const DomainSpecification::PropositionSet& some
+                = act->second->getPropositions();
                     
-                    StateLabelling* tmp = const_cast<StateLabelling*>(&nmrsLabels);
+            StateLabelling* tmp = const_cast<StateLabelling*>(&nmrsLabels);
                     
-                    dynamic_cast<basedExpandedState*>(act->second)
-                        ->setLabelSet( *(*tmp)[some] );
+            dynamic_cast<basedExpandedState*>(act->second)
+                ->setLabelSet( *(*tmp)[some] );
+        }
+}
 
+void StateAnnotationExpansion::adjustState(State* state,
+                                           const StateLabelling& nmrsLabels) const
+{   
+    /*Calculate and adjust the reward specification of the state.*/
+    
+    /*If we are going for a minimised state space.*/
+    if(0 != nmrsLabels.size())
+    {
+        /*In some instances state adjustment requires a filter.*/
+        MinimalEntailmentFilter filter =
+            MinimalEntailmentFilter(dynamic_cast<basedExpandedState*>(state)->getRewardSpecification());
                     
-                    /*In some instances state adjustment requires a filter.*/
-                    MinimalEntailmentFilter filter =
-                        MinimalEntailmentFilter(dynamic_cast<basedExpandedState*>(act->second)->getRewardSpecification());
-                    
-                    act->second->calculateReward(&filter);
-                }
-            else
-                act->second->calculateReward();
-        }
+        state->calculateReward(&filter);
+    }
+    else
+        state->calculateReward();
 }
@@ -62,7 +62,13 @@ namespace MDP
     {
     public:
         /*Expands the \argument{State} given the
-         *\argument{DomainSpecification}.*/
+         *\argument{DomainSpecification}.
+         *
+         *Successor states are generated and labelled by the calling
+         *thread. The rewards of the successors are then calculated by
+         *the threads of the \class{WorkerPool}, each successor's
+         *reward depends only on that successor thus the result does
+         *not depend on the number of threads.*/
         virtual StateTransitionMatrices*
         operator()(State&,
                    DomainSpecification&,
@@ -72,15 +78,30 @@ namespace MDP
          *during \function{newState()} generation.*/
         mutable State* stateLastToExpand;
 
+        /*Calculation of the rewards of a set of successors (see
+         *\method{adjustState()}) by a \class{WorkerPool}.*/
+        class RewardTask;
+
         /*The \argument{ActionPossibilities} contain the probabilities
          *and \class{eStates} associated with some state transition in
          *this domain. The \argument{StateLabelling} comprises the
          *reward labels for grounded or NMRDP states. This method
-         *calculates the reward associated with the
-         *\argument{ActionPossibilities} \class{eState}s assuming that
-         *their current \class{rewardSpecification}s equal those of
-         *their parents.*/
-        virtual void adjustStates(ActionPossibilities&, const StateLabelling&) const;
+         *labels the \argument{ActionPossibilities} \class{eState}s
+         *with the \argument{StateLabelling}. It is only called by the
+         *thread executing \method{operator()}.*/
+        virtual void labelStates(ActionPossibilities&, const StateLabelling&) const;
+
+        /*This method calculates the reward associated with a labelled
+         *successor \argument{State}, assuming that its current
+         *\class{rewardSpecification} equals that of its parent. Calls
+         *for distinct states may be concurrent, thus only the
+         *argument state may be altered. This holds as the formulae
+         *traversed are those of the state's own
+         *\class{rewardSpecification}, or immutable nodes of a
+         *\class{FormulaTable}, and the visitation state of a
+         *traversal lives on the stack of the visiting thread (see
+         *\method{formula::accept()}).*/
+        virtual void adjustState(State*, const StateLabelling&) const;
         
         /*Generates the \argument{ActionPossibilities} such that no
          *resultant element in that vector occurs with zero
@@ -107,7 +128,9 @@ namespace MDP
     class StateAnnotationExpansion : public Expansion
     {
     protected:
-        void adjustStates(ActionPossibilities&, const StateLabelling&) const;
+        void labelStates(ActionPossibilities&, const StateLabelling&) const;
+
+        void adjustState(State*, const StateLabelling&) const;
     };
 
 /******************************************************************/
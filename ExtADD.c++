@@ -29,6 +29,7 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <map>
 using namespace std;
 
 #include "include/cuddObj.hh"
@@ -356,6 +357,77 @@ PUBLIC vector<int> ExtADD::variablesUsed(int numVars, bool invert DEFVAL(false))
     return result;
 }
 
+/* Collect the values of the leaves reachable from `node', each node
+ * is visited once. */
+static void collectLeafValues(DdNode *node, set<DdNode *> &visited, set<double> &values)
+{
+    if (!visited.insert(node).second)
+        return;
+    if (Cudd_IsConstant(node)) {
+        values.insert(Cudd_V(node));
+    } else {
+        collectLeafValues(Cudd_T(node), visited, values);
+        collectLeafValues(Cudd_E(node), visited, values);
+    }
+}
+
+/* Return an approximation of this ADD in which leaves whose values
+ * lie within `tolerance' of each other are merged, as in APRICODD.
+ * Leaves are merged in order of value, each range of merged leaves
+ * being replaced by its midpoint.  The greatest change of any leaf
+ * is stored in `error'. */
+PUBLIC ExtADD ExtADD::approximate(double tolerance, double &error) const
+{
+    set<DdNode *> visited;
+    set<double> values;
+    collectLeafValues(getNode(), visited, values);
+
+    map<double, double> merged;
+    error = 0.0;
+    set<double>::const_iterator first = values.begin();
+    while (first != values.end()) {
+        set<double>::const_iterator last = first;
+        set<double>::const_iterator next = first;
+        while (next != values.end() && *next - *first <= tolerance)
+            last = next++;
+
+        double midpoint = (*first + *last) / 2;
+        error = max(error, (*last - *first) / 2);
+        for (; first != next; ++first)
+            merged[*first] = midpoint;
+    }
+
+    // nothing was merged
+    if (0.0 == error)
+        return *this;
+
+    map<DdNode *, ExtADD> replaced;
+    return replaceLeaves(merged, replaced);
+}
+
+/* Return this ADD with each leaf value replaced by the value it maps
+ * to in `values'.  `replaced' holds the results for the nodes that
+ * have been visited. */
+PRIVATE ExtADD ExtADD::replaceLeaves(const map<double, double> &values,
+                                     map<DdNode *, ExtADD> &replaced) const
+{
+    map<DdNode *, ExtADD>::const_iterator known = replaced.find(getNode());
+    if (known != replaced.end())
+        return known->second;
+
+    ExtADD result;
+    if (isConstant()) {
+        result = manager()->constant(values.find(value())->second);
+    } else {
+        ExtADD self = var();
+        result = (self & thenChild().replaceLeaves(values, replaced))
+            + ((~self) & elseChild().replaceLeaves(values, replaced));
+    }
+
+    replaced[getNode()] = result;
+    return result;
+}
+
 /* The maximum value of leaf nodes in this ADD
  */
 PUBLIC double ExtADD::maximumValue() const
@@ -0,0 +1,251 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include<cmath>
+
+#include"IncrementalValueIteration.h++"
+#include"domainSpecification_Anytime_or_Explicit.h++"
+#include"Instrumentation.h++"
+
+IncrementalValueIteration::IncrementalValueIteration(DomainSpecification* domSpec)
+    : Algorithm(*domSpec),
+      policy(0)
+{
+    cerr<<"An attempt to execute explicit value iteration with a non--explicit domain will fail!\n";
+}
+
+IncrementalValueIteration::IncrementalValueIteration(explicitDomainSpecification& domSpec,
+                                                     double gamma,
+                                                     double epsilon,
+                                                     bool delayInitialisation)
+    : Algorithm(domSpec, gamma, epsilon)
+{
+    configurePolicy(domSpec);
+
+    dynamics.setActions(*domSpec.getActionSpecification());
+
+    if(!delayInitialisation)
+    {
+        vector<eState*> states;
+        states = domSpec.getStates(states);
+
+        includeStates(std::set<eState*>(states.begin(), states.end()));
+    }
+}
+
+IncrementalValueIteration::IncrementalValueIteration(explicitDomainSpecification& domSpec)
+    : Algorithm(domSpec)
+{
+    configurePolicy(domSpec);
+
+    dynamics.setActions(*domSpec.getActionSpecification());
+
+    vector<eState*> states;
+    states = domSpec.getStates(states);
+
+    includeStates(std::set<eState*>(states.begin(), states.end()));
+}
+
+void IncrementalValueIteration::configurePolicy(explicitDomainSpecification& domSpec)
+{
+    policy = domSpec.getPolicy();
+}
+
+unsigned int IncrementalValueIteration::identifyState(eState* state)
+{
+    map<eState*, int>::const_iterator stateId = stateIds.find(state);
+
+    if(stateIds.end() != stateId)
+        return stateId->second;
+
+    unsigned int id = domainStates.size();
+
+    stateIds[state] = id;
+    domainStates.push_back(state);
+
+    /*Values are kept from one step to the next, thus a new state
+      begins with the value it has been given so far.*/
+    values.push_back(state->getValue());
+    rewards.push_back(state->getReward());
+    rows.push_back(CompressedDynamics::noChoice);
+    predecessors.push_back(vector<unsigned int>());
+    choices.push_back(CompressedDynamics::noChoice);
+    expanded.push_back(false);
+    priorities.push_back(0.0);
+    altered.push_back(false);
+
+    return id;
+}
+
+void IncrementalValueIteration::configureActions(unsigned int id)
+{
+    eState* state = domainStates[id];
+
+    /*Every successor must have an identity before the row is
+      appended, otherwise it would be ignored.*/
+    for(State::iterator stateAction = state->begin()
+            ; stateAction != state->end()
+            ; ++stateAction)
+        for(ActionPossibilities::const_iterator transitionPair
+                = stateAction->second.begin()
+                ; transitionPair != stateAction->second.end()
+                ; ++transitionPair)
+            identifyState(dynamic_cast<eState*>(transitionPair->second));
+
+    unsigned int row = dynamics.numberOfStates();
+    rows[id] = row;
+    dynamics.addState(state, stateIds);
+
+    /*Record the state as a predecessor of each of its successors.*/
+    for(unsigned int choice = dynamics.beginChoice(row)
+            ; choice != dynamics.endChoice(row)
+            ; ++choice)
+        for(unsigned int entry = dynamics.beginSuccessor(choice)
+                ; entry != dynamics.endSuccessor(choice)
+                ; ++entry)
+        {
+            vector<unsigned int>& successorPredecessors
+                = predecessors[dynamics.getSuccessor(entry)];
+
+            if(successorPredecessors.empty() || id != successorPredecessors.back())
+                successorPredecessors.push_back(id);
+        }
+}
+
+void IncrementalValueIteration::enqueue(unsigned int id, double error)
+{
+    priorities[id] += error;
+    queue.push(pair<double, unsigned int>(priorities[id], id));
+}
+
+void IncrementalValueIteration::includeStates(const std::set<eState*>& states)
+{
+    for(std::set<eState*>::const_iterator state = states.begin()
+            ; state != states.end()
+            ; ++state)
+    {
+        unsigned int id = identifyState(*state);
+
+        if(FRINGE == (*state)->getColour())
+        {
+            /*This state is not backed up, its value is fixed.*/
+            double change = fabs((*state)->getValue() - values[id]);
+            if(0.0 != change)
+            {
+                values[id] = (*state)->getValue();
+
+                for(vector<unsigned int>::const_iterator predecessor = predecessors[id].begin()
+                        ; predecessor != predecessors[id].end()
+                        ; ++predecessor)
+                    enqueue(*predecessor, gamma * change);
+            }
+
+            continue;
+        }
+
+        if(expanded[id])
+            continue;
+
+        /*Append the row of a state that is included expanded for the
+          first time, its value has yet to be backed up.*/
+        expanded[id] = true;
+        if((*state)->begin() != (*state)->end())
+            configureActions(id);
+        enqueue(id, HUGE_VAL);
+    }
+}
+
+void IncrementalValueIteration::updateStateValues()
+{
+    for(vector<unsigned int>::const_iterator id = alteredStates.begin()
+            ; id != alteredStates.end()
+            ; ++id)
+    {
+        domainStates[*id]->setValue(values[*id]);
+        altered[*id] = false;
+    }
+
+    alteredStates.clear();
+}
+
+bool IncrementalValueIteration::operator()()
+{
+    double acceptableError = epsilon * ((1 - gamma)/(2*gamma));
+
+    Algorithm::error = 0.0;
+
+    while(!queue.empty())
+    {
+        double priority = queue.top().first;
+        unsigned int id = queue.top().second;
+
+        /*Ignore entries that have been superseded.*/
+        if(priority != priorities[id])
+        {
+            queue.pop();
+            continue;
+        }
+
+        if(priority <= acceptableError)
+        {
+            Algorithm::error = priority;
+            break;
+        }
+
+        queue.pop();
+
+        priorities[id] = 0.0;
+
+        unsigned int choice = CompressedDynamics::noChoice;
+
+        double value = rewards[id];
+        if(CompressedDynamics::noChoice != rows[id])
+        {
+            ScopedTimer timer(Instrumentation::bellmanBackup);
+            value += dynamics.backup(rows[id], &values[0], gamma, choice);
+        }
+
+        /*Was some action superior for this state?*/
+        if(CompressedDynamics::noChoice != choice && choice != choices[id])
+        {
+            (*policy)[domainStates[id]] = dynamics.getAction(choice);
+            choices[id] = choice;
+        }
+
+        double change = fabs(value - values[id]);
+
+        if(0.0 == change)
+            continue;
+
+        values[id] = value;
+
+        if(!altered[id])
+        {
+            altered[id] = true;
+            alteredStates.push_back(id);
+        }
+
+        /*The Bellman error of each predecessor of the state grows by
+          at most $\gamma$ times the change of this value.*/
+        for(vector<unsigned int>::const_iterator predecessor = predecessors[id].begin()
+                ; predecessor != predecessors[id].end()
+                ; ++predecessor)
+            enqueue(*predecessor, gamma * change);
+    }
+
+    return true;
+}
@@ -0,0 +1,183 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+/*
+ * \paragraph{:Purpose:}
+ *
+ * Value iteration for the dynamic programming step of \class{LAO}
+ * that is not restarted at each step. Between calls to
+ * \method{LAO::operator()()} only a few fringe states are expanded,
+ * yet the other explicit algorithms rebuild their dynamics and
+ * recompute every value from the immediate reward. Here states are
+ * only ever added. The row of a state in the \class{CompressedDynamics}
+ * is appended when the state is first seen expanded, and its value is
+ * kept from one step to the next.
+ *
+ * Backups are prioritised (prioritised sweeping). The priority of a
+ * state is a bound on its Bellman error, the difference between its
+ * value and that of a backup. A backup makes the error of the state
+ * $0$, and a change of $\delta$ in the value of a successor adds at
+ * most $\gamma \delta$ to it. Newly expanded states have an
+ * unbounded error, so they are backed up first. A step ends once no
+ * state has an error exceeding $\epsilon (1 - \gamma) / 2 \gamma$,
+ * the bound on the change of an iteration at which
+ * \class{ValueIteration} terminates. Thus the values meet the same
+ * guarantee.
+ *
+ * \class{LAO} gives \method{includeStates()} only the states it has
+ * expanded since the last step and their successors. The ancestors
+ * of an expanded state are backed up as the change of its value
+ * reaches them, thus every expanded state of the explicit graph may
+ * be backed up, not only those of the best partial solution. The
+ * search of \class{LAO} for a fringe state still takes time linear in
+ * the size of the best partial solution.
+ * */
+#ifndef INCREMENTAL_VALUE_ITERATION
+#define INCREMENTAL_VALUE_ITERATION
+
+#include<set>
+#include<queue>
+
+#include "Algorithm.h++"
+#include "CompressedDynamics.h++"
+
+using namespace std;
+
+namespace MDP
+{
+    class IncrementalValueIteration : public Algorithm
+    {
+    public:
+        /*Value iteration can be used as the dynamic programming step
+         *in \class{LAO}.*/
+        friend class LAO<IncrementalValueIteration>;
+
+        /*A call to this constructor results in erroneous behaviour as
+         *this is a state based algorithm (ie: requires an
+         *\class{explicitDomainSpecification}).*/
+        IncrementalValueIteration(DomainSpecification* domSpec);
+
+        /*Construct the algorithmic object with \argument{domSpec} as
+         *the specification on which the algorithms is to be executed,
+         *\argument{gamma} the discount factor and \argument{epsilon}
+         *the acceptable error.
+         *
+         *Unless \argument{delayInitialisation} is $true$ all the
+         *states of the \argument{domSpec} are included (see
+         *\method{includeStates()}).*/
+        IncrementalValueIteration(explicitDomainSpecification& domSpec,
+                                  double gamma,
+                                  double epsilon,
+                                  bool delayInitialisation = false);
+
+        /*Construct the algorithmic object with \argument{domSpec} as
+         *the specification on which the algorithms is to be
+         *executed. Discounting and error is taken to be the defaults
+         *provided by the \parent{Algorithm}.*/
+        IncrementalValueIteration(explicitDomainSpecification& domSpec);
+
+        /*Set the algorithm policy to that of the
+         *\argument{explicitDomainSpecification}*/
+        void configurePolicy(explicitDomainSpecification&);
+
+        /*The argument states are new to the next call to
+         *\method{operator()()}, or have been expanded since they were
+         *last included. States not seen before are given identities,
+         *and the rows of expanded states not seen expanded before are
+         *appended to the \member{dynamics} and queued for backup.
+         *
+         *FRINGE states are not backed up, their value is taken to be
+         *\member{State.getValue()}.*/
+        void includeStates(const std::set<eState*>&);
+
+        /*Update the value associated with every state whose value has
+         *been altered since the last call.*/
+        void updateStateValues();
+
+        /*Back up states in order of priority until no state has a
+         *priority exceeding the termination error
+         *(see file comment). This always returns $true$.
+         *\member{Algorithm::error} is the greatest priority left.*/
+        bool operator()();
+    private:
+        /*Give the argument state an identity, unless it has one
+         *already. The result is the identity of the state.*/
+        unsigned int identifyState(eState*);
+
+        /*Append the row of the state with the argument identity to
+         *the \member{dynamics}.*/
+        void configureActions(unsigned int id);
+
+        /*Add \argument{error} to the priority of the state with the
+         *argument identity and queue it with the new priority.*/
+        void enqueue(unsigned int id, double error);
+
+        /*Sequence of \class{eState}s that have been included, in
+         *order of identity.*/
+        vector<eState*> domainStates;
+
+        /*Index of states.*/
+        map<eState*, int> stateIds;
+
+        /*System dynamics. Rows are in order of expansion rather than
+         *of identity (see \member{rows}).*/
+        CompressedDynamics dynamics;
+
+        /*Row of the \member{dynamics} of each state, or
+         *\member{CompressedDynamics::noChoice} where the state has not
+         *been seen expanded.*/
+        vector<unsigned int> rows;
+
+        /*States from which each state is reachable in one step.*/
+        vector<vector<unsigned int> > predecessors;
+
+        /*Value of each state.*/
+        vector<double> values;
+
+        /*Immediate reward of each state.*/
+        vector<double> rewards;
+
+        /*Choice last written to the \member{policy} for each state.*/
+        vector<unsigned int> choices;
+
+        /*Has the state at the same index been included other than
+         *as a FRINGE state?*/
+        vector<char> expanded;
+
+        /*Bound on the Bellman error of each state, the priority with
+         *which it is queued, $0$ if it is not.*/
+        vector<double> priorities;
+
+        /*States queued for backup, greatest priority first. Where a
+         *state is queued more than once only the entry matching its
+         *\member{priorities} is valid.*/
+        priority_queue<pair<double, unsigned int> > queue;
+
+        /*States whose value has been altered since the last call to
+         *\method{updateStateValues()}.*/
+        vector<unsigned int> alteredStates;
+
+        /*Has the state at the same index been altered (see
+         *\member{alteredStates})?*/
+        vector<char> altered;
+
+        /*Current policy.*/
+        Policy* policy;
+    };
+};
+
+#endif
@@ -0,0 +1,268 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include"Instrumentation.h++"
+
+#include<ctime>
+#include<cstdio>
+#include<vector>
+#include<sstream>
+#include<iomanip>
+#include<fstream>
+#include<pthread.h>
+
+/*Greatest number of events recorded by one thread. Events beyond
+ *this are counted but not recorded.*/
+static const unsigned int traceLimit = 1 << 20;
+
+/*A scope of a probe recorded while tracing.*/
+struct TraceEvent
+{
+    Instrumentation::Probe probe;
+    unsigned long long begin;
+    unsigned long long duration;
+};
+
+/*Events recorded by one thread.*/
+struct TraceBuffer
+{
+    /*Guards the \member{events} and \member{dropped} count. It is
+     *only contended while the buffer is reset or dumped.*/
+    pthread_mutex_t mutex;
+
+    vector<TraceEvent> events;
+
+    /*Number of events not recorded as the \member{events} were
+     *full.*/
+    unsigned long long dropped;
+};
+
+/*Buffer of the calling thread, $0$ until it records an event.*/
+static __thread TraceBuffer* threadBuffer = 0;
+
+/*Buffers of all the threads that have recorded an event. Buffers are
+ *kept for the life of the application, as a thread may record again
+ *after a \method{Instrumentation::reset()}.*/
+static vector<TraceBuffer*> buffers;
+
+/*Guards the \member{buffers}. Where both are held this is taken
+ *before the mutex of a buffer.*/
+static pthread_mutex_t buffersMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const char* probeNames[Instrumentation::numberOfProbes] =
+{
+    "successorGeneration",
+    "stateStoreLookup",
+    "stateStoreInsertion",
+    "rewardProgression",
+    "rewardRegression",
+    "formulaSimplification",
+    "bellmanBackup",
+    "cuddOperation",
+    "cuddReordering"
+};
+
+bool Instrumentation::enabled = false;
+bool Instrumentation::tracing = false;
+unsigned long long Instrumentation::counts[numberOfProbes];
+unsigned long long Instrumentation::times[numberOfProbes];
+unsigned long long Instrumentation::origin = 0;
+
+void Instrumentation::setEnabled(bool enable)
+{
+    enabled = enable;
+
+    if(!enable)
+        tracing = false;
+}
+
+void Instrumentation::setTracing(bool trace)
+{
+    if(trace && !tracing)
+        origin = now();
+
+    tracing = trace;
+
+    if(trace)
+        enabled = true;
+}
+
+void Instrumentation::reset()
+{
+    for(unsigned int probe = 0; probe < numberOfProbes; ++probe)
+    {
+        counts[probe] = 0;
+        times[probe] = 0;
+    }
+
+    pthread_mutex_lock(&buffersMutex);
+    for(vector<TraceBuffer*>::iterator buffer = buffers.begin()
+            ; buffer != buffers.end()
+            ; ++buffer)
+    {
+        pthread_mutex_lock(&(*buffer)->mutex);
+        (*buffer)->events.clear();
+        (*buffer)->dropped = 0;
+        pthread_mutex_unlock(&(*buffer)->mutex);
+    }
+    pthread_mutex_unlock(&buffersMutex);
+
+    origin = now();
+}
+
+const char* Instrumentation::getName(Probe probe)
+{
+    return probeNames[probe];
+}
+
+unsigned long long Instrumentation::getCount(Probe probe)
+{
+    return counts[probe];
+}
+
+double Instrumentation::getTime(Probe probe)
+{
+    return times[probe] / 1e9;
+}
+
+string Instrumentation::report()
+{
+    ostringstream result;
+
+    result<<setw(24)<<left<<"probe"
+          <<setw(16)<<right<<"count"
+          <<setw(16)<<"seconds"
+          <<setw(16)<<"mean (us)"<<endl;
+
+    for(unsigned int probe = 0; probe < numberOfProbes; ++probe)
+    {
+        Probe p = static_cast<Probe>(probe);
+
+        result<<setw(24)<<left<<getName(p)
+              <<setw(16)<<right<<getCount(p)
+              <<setw(16)<<fixed<<setprecision(6)<<getTime(p)
+              <<setw(16)<<setprecision(3)
+              <<((0 == getCount(p)) ? 0.0 : times[probe] / 1e3 / getCount(p))
+              <<endl;
+    }
+
+    return result.str();
+}
+
+/*Threads may record while the trace is dumped. Each buffer is locked
+ *while it is written, so the events of a buffer are those it held at
+ *some point during the dump.*/
+bool Instrumentation::dumpTrace(const string& filename)
+{
+    ofstream trace(filename.c_str());
+
+    if(!trace)
+        return false;
+
+    trace<<"{\"traceEvents\":[";
+
+    bool first = true;
+    unsigned long long dropped = 0;
+
+    pthread_mutex_lock(&buffersMutex);
+    for(unsigned int thread = 0; thread < buffers.size(); ++thread)
+    {
+        pthread_mutex_lock(&buffers[thread]->mutex);
+
+        const vector<TraceEvent>& events = buffers[thread]->events;
+        dropped += buffers[thread]->dropped;
+
+        for(vector<TraceEvent>::const_iterator event = events.begin()
+                ; event != events.end()
+                ; ++event)
+        {
+            if(!first)
+                trace<<",";
+            first = false;
+
+            /*Complete events, times are in microseconds.*/
+            trace<<"\n{\"name\":\""<<getName(event->probe)
+                 <<"\",\"ph\":\"X\",\"pid\":1,\"tid\":"<<thread
+                 <<",\"ts\":"<<fixed<<setprecision(3)
+                 <<((event->begin > origin) ? event->begin - origin : 0) / 1e3
+                 <<",\"dur\":"<<event->duration / 1e3<<"}";
+        }
+
+        pthread_mutex_unlock(&buffers[thread]->mutex);
+    }
+    pthread_mutex_unlock(&buffersMutex);
+
+    trace<<"\n],\"otherData\":{\"droppedEvents\":\""<<dropped<<"\"";
+    for(unsigned int probe = 0; probe < numberOfProbes; ++probe)
+    {
+        Probe p = static_cast<Probe>(probe);
+        trace<<",\""<<getName(p)<<".count\":\""<<getCount(p)<<"\""
+             <<",\""<<getName(p)<<".seconds\":\""<<setprecision(6)<<getTime(p)<<"\"";
+    }
+    trace<<"}}\n";
+
+    return !trace.fail();
+}
+
+unsigned long long Instrumentation::now()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec * 1000000000ULL + time.tv_nsec;
+}
+
+void Instrumentation::record(Probe probe, unsigned long long items, unsigned long long begin)
+{
+    unsigned long long end = now();
+
+    add(probe, items, end - begin);
+
+    if(!tracing)
+        return;
+
+    if(0 == threadBuffer)
+    {
+        threadBuffer = new TraceBuffer;
+        pthread_mutex_init(&threadBuffer->mutex, 0);
+        threadBuffer->dropped = 0;
+
+        pthread_mutex_lock(&buffersMutex);
+        buffers.push_back(threadBuffer);
+        pthread_mutex_unlock(&buffersMutex);
+    }
+
+    TraceEvent event;
+    event.probe = probe;
+    event.begin = begin;
+    event.duration = end - begin;
+
+    pthread_mutex_lock(&threadBuffer->mutex);
+    if(threadBuffer->events.size() >= traceLimit)
+        ++threadBuffer->dropped;
+    else
+        threadBuffer->events.push_back(event);
+    pthread_mutex_unlock(&threadBuffer->mutex);
+}
+
+void Instrumentation::add(Probe probe, unsigned long long items, unsigned long long time)
+{
+    __sync_fetch_and_add(&counts[probe], items);
+
+    if(0 != time)
+        __sync_fetch_and_add(&times[probe], time);
+}
@@ -0,0 +1,178 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+/*
+ * \paragraph{:Purpose:}
+ *
+ * Counters and timers placed on the hot paths of the solution
+ * methods. The threads of \module{MeasurementThreads} poll the
+ * domain at intervals, and each poll walks the states they
+ * measure. A probe here is instead updated by the code being
+ * measured, as it runs.
+ *
+ * Each \class{Instrumentation::Probe} has a count of the items it
+ * has seen and the time spent in its scopes (see
+ * \class{ScopedTimer}). While the probes are disabled, the default,
+ * a probe costs the test of one flag. While tracing, every scope is
+ * also recorded as an event, and the events can be written to a
+ * trace file in the JSON format read by Chrome's about:tracing and
+ * by Perfetto.
+ *
+ * Probes are controlled by the \textbf{probes} and
+ * \textbf{dumpProbes} commands of the \class{CommandInterpreter}.
+ * */
+
+#ifndef INSTRUMENTATION
+#define INSTRUMENTATION
+
+#include<string>
+
+using namespace std;
+
+class Instrumentation
+{
+public:
+    /*Points of the code that are measured.*/
+    enum Probe
+    {
+        /*Expansion of a state into its successors (see
+         *\class{Expansion}).*/
+        successorGeneration,
+
+        /*Search of the \class{StateStore} for a state.*/
+        stateStoreLookup,
+
+        /*Addition of a state to the \class{StateStore}. This probe
+         *counts, it is not timed.*/
+        stateStoreInsertion,
+
+        /*Calculation of the reward of a state by FLTL progression.*/
+        rewardProgression,
+
+        /*Calculation of the reward of a state by PLTL regression.*/
+        rewardRegression,
+
+        /*Simplification of a formula.*/
+        formulaSimplification,
+
+        /*Bellman backups, one item per state backed up.*/
+        bellmanBackup,
+
+        /*Operations on decision diagrams, one item per iteration of
+         *\class{Spudd}.*/
+        cuddOperation,
+
+        /*Dynamic reordering of the decision diagram variables.*/
+        cuddReordering,
+
+        numberOfProbes
+    };
+
+    /*Are the probes counting and timing?*/
+    static bool isEnabled(){return enabled;}
+
+    /*Are the scopes of the probes recorded as trace events?*/
+    static bool isTracing(){return tracing;}
+
+    /*Start or stop counting and timing. Stopping also stops
+     *tracing.*/
+    static void setEnabled(bool);
+
+    /*Start or stop recording trace events. Starting also starts
+     *counting and timing.*/
+    static void setTracing(bool);
+
+    /*Zero all the counts and times and discard the trace events.*/
+    static void reset();
+
+    /*Name of the argument probe, as reported.*/
+    static const char* getName(Probe);
+
+    /*Number of items seen by the argument probe.*/
+    static unsigned long long getCount(Probe);
+
+    /*Time, in seconds, spent in scopes of the argument probe.*/
+    static double getTime(Probe);
+
+    /*Table of the count and time of every probe.*/
+    static string report();
+
+    /*Write the recorded trace events and the probe totals to the
+     *file \argument{filename}. Returns $false$ if the file could not
+     *be written.*/
+    static bool dumpTrace(const string& filename);
+
+    /*Add \argument{items} to the count of the argument probe.*/
+    static void count(Probe probe, unsigned long long items = 1)
+    {
+        if(enabled)
+            add(probe, items, 0);
+    }
+
+    /*Monotonic time in nanoseconds.*/
+    static unsigned long long now();
+
+    /*End of a scope of the argument probe that began at time
+     *\argument{begin} (see \method{now()}).*/
+    static void record(Probe, unsigned long long items, unsigned long long begin);
+private:
+    /*Add to the count and time of a probe. Safe to call from the
+     *threads of the \class{WorkerPool}.*/
+    static void add(Probe, unsigned long long items, unsigned long long time);
+
+    static bool enabled;
+
+    static bool tracing;
+
+    /*Number of items seen by each probe.*/
+    static unsigned long long counts[numberOfProbes];
+
+    /*Nanoseconds spent in the scopes of each probe.*/
+    static unsigned long long times[numberOfProbes];
+
+    /*Time at which tracing last started, trace events are relative
+     *to this.*/
+    static unsigned long long origin;
+};
+
+/*A scope of a probe. The time between construction and destruction
+ *is added to the probe. If the probes are not enabled at
+ *construction nothing is recorded.*/
+class ScopedTimer
+{
+public:
+    ScopedTimer(Instrumentation::Probe probe, unsigned long long items = 1)
+        :probe(probe),
+         items(items),
+         begin(Instrumentation::isEnabled() ? Instrumentation::now() : 0){}
+
+    ~ScopedTimer()
+    {
+        if(0 != begin)
+            Instrumentation::record(probe, items, begin);
+    }
+private:
+    Instrumentation::Probe probe;
+    unsigned long long items;
+    unsigned long long begin;
+
+    /*Ensure that a \class{ScopedTimer} cannot be copied.*/
+    ScopedTimer(const ScopedTimer&);
+    ScopedTimer& operator=(const ScopedTimer&);
+};
+
+#endif
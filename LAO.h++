@@ -48,7 +48,10 @@ namespace MDP
      *
      *This class has access to both explicit value and policy
      *iteration members (see \module{PolicyIteration} and
-     *\module{ValueIteration}). It is their friend.
+     *\module{ValueIteration}). It is their friend. Where the
+     *algorithm is an \class{IncrementalValueIteration} the dynamic
+     *programming step is not restarted on each call to
+     *\method{operator()()}.
      **/
     template<class ExplicitAlgorithm>
     class LAO : public Algorithm
@@ -94,6 +97,12 @@ namespace MDP
          *is made EXPLICIT its successors are added to the graph
          *(again these may need to be marked as EXPLICIT).*/
         void completeExplicitGraph(std::set<eState*>& allStatesSet);
+
+        /*Execute Bellman backup on the explicit graph
+         *\argument{allStatesSet} until convergence, and update the
+         *values of the states accordingly. FRINGE states are given
+         *the \member{expectedFringeReward}.*/
+        void dynamicProgramming(const std::set<eState*>& allStatesSet);
         
         /*This function expands the best solution graph searching for
          *a fringe state. $false$ is returned if no fringe is found. States
@@ -126,6 +135,10 @@ namespace MDP
          *This function can only expand $FRINGE$ states.*/
         SuccesorList* expandFringeNode(eState*, std::set<eState*>&);
 
+        /*States expanded since the last dynamic programming step (see
+         *\method{expandFringeNode()}).*/
+        SuccesorList expandedStates;
+
         /*\class{eState} from which the explicit graph is expanded.*/
         eState* startState;
 
@@ -17,6 +17,9 @@
 
 #include"ValueIteration.h++"
 #include"PolicyIteration.h++"
+#include"CompressedValueIteration.h++"
+#include"CompressedPolicyIteration.h++"
+#include"IncrementalValueIteration.h++"
 #include"domainSpecification_Anytime_or_Explicit.h++"
 
 using namespace MDP;
@@ -91,6 +94,7 @@ LAO<ExplicitAlgorithm>::expandFringeNode(eState* toExpand, std::set<eState*>& al
     
     /*Expand the $oldTop$ \member{explDomSpec} fringe node.*/
     explDomSpec->expandFringe(toExpand);
+    expandedStates.push_back(toExpand);
 
     /*Respect control knowledge.*/
     if(useControlKnowledge)
@@ -455,6 +459,98 @@ bool LAO<ExplicitAlgorithm>::forwardSearch(Policy* policy,
 /*****************************SEARCH******************************************/
 
 
+/*****************************DYNAMIC PROGRAMMING******************************************/
+
+template<class ExplicitAlgorithm>
+void LAO<ExplicitAlgorithm>::dynamicProgramming(const std::set<eState*>& allStatesSet)
+{
+    /*Algorithm used for Bellman backup.*/
+    dynamicProgrammingStep = ExplicitAlgorithm(*explDomSpec, gamma, epsilon, true);
+
+    dynamicProgrammingStep.domainStates = vector<eState*>(0);
+
+    for(std::set<eState*>::const_iterator state = allStatesSet.begin()
+            ; state != allStatesSet.end()
+            ; ++state)
+        dynamicProgrammingStep.domainStates.push_back(*state);
+        
+    /*Use state colours to assign values to them.*/
+    for(unsigned int i = 0; i < dynamicProgrammingStep.domainStates.size(); ++i)
+        if(FRINGE == dynamicProgrammingStep.domainStates[i]->getColour())
+            dynamicProgrammingStep.domainStates[i]->setValue(expectedFringeReward);
+    
+    dynamicProgrammingStep.stateIds = map<eState*, int>();
+    
+    dynamicProgrammingStep.identifyStates();
+    
+    dynamicProgrammingStep.configurePolicy(*explDomSpec);
+
+    dynamicProgrammingStep.initialiseActions();
+    
+    dynamicProgrammingStep.configureActions(false);
+
+    dynamicProgrammingStep.initialiseValueVectors();
+    
+    /*Run Bellman backup, dynamic programming step, until
+      convergence.*/
+    while(!dynamicProgrammingStep())
+    {/*TODO:: Weaker stopping condition in the case of Value Iteration.*/};
+ 
+    /*Update the values associated with domain states. Only values
+      associated with states coloured for deletion ($MARKED$) are
+      used.*/
+    dynamicProgrammingStep.updateStateValues();
+
+    expandedStates.clear();
+}
+
+/*The incremental algorithm retains its states, values and dynamics
+  between calls, only the states expanded since the last call and
+  their successors are given. Where the algorithm was started afresh
+  every state of the explicit graph is given.*/
+template<>
+inline void LAO<IncrementalValueIteration>::dynamicProgramming(const std::set<eState*>& allStatesSet)
+{
+    std::set<eState*> newStates;
+
+    if(dynamicProgrammingStep.domainStates.empty())
+        newStates = allStatesSet;
+    else
+        for(SuccesorList::const_iterator expandedState = expandedStates.begin()
+                ; expandedState != expandedStates.end()
+                ; ++expandedState)
+        {
+            newStates.insert(*expandedState);
+
+            for(StateTransitionMatrices::const_iterator transition = (*expandedState)->begin()
+                    ; transition != (*expandedState)->end()
+                    ; ++transition)
+                for(ActionPossibilities::const_iterator successor = transition->second.begin()
+                        ; successor != transition->second.end()
+                        ; ++successor)
+                    newStates.insert(dynamic_cast<eState*>(successor->second));
+        }
+
+    expandedStates.clear();
+
+    /*Use state colours to assign values to them.*/
+    for(std::set<eState*>::const_iterator state = newStates.begin()
+            ; state != newStates.end()
+            ; ++state)
+        if(FRINGE == (*state)->getColour())
+            (*state)->setValue(expectedFringeReward);
+
+    dynamicProgrammingStep.includeStates(newStates);
+
+    /*Run prioritised Bellman backup until convergence.*/
+    while(!dynamicProgrammingStep()){};
+
+    /*Only the values altered by this step are updated.*/
+    dynamicProgrammingStep.updateStateValues();
+}
+
+/*****************************DYNAMIC PROGRAMMING******************************************/
+
 /*(LAO*)*/
 template<class ExplicitAlgorithm>
 bool LAO<ExplicitAlgorithm>::operator()()
@@ -505,6 +601,10 @@ bool LAO<ExplicitAlgorithm>::operator()()
                         ; ++p)
                     delete *p;
 
+                /*States may have been removed, thus the dynamic
+                  programming step is started afresh.*/
+                dynamicProgrammingStep = ExplicitAlgorithm(*explDomSpec, gamma, epsilon, true);
+
                 /*Try LAO* again.*/
                 return operator()();
             }
@@ -538,50 +638,16 @@ bool LAO<ExplicitAlgorithm>::operator()()
     
 
     /*Execute Bellman backup until convergence.*/
-        
-    /*Algorithm used for Bellman backup.*/
-    dynamicProgrammingStep = ExplicitAlgorithm(*explDomSpec, gamma, epsilon, true);
-
-    dynamicProgrammingStep.domainStates = vector<eState*>(0);
+    dynamicProgramming(allStatesSet);
 
+    /*Remove all transitions from newly explored states and colour
+      them as "having been explored".*/
     for(std::set<eState*>::const_iterator state = allStatesSet.begin()
             ; state != allStatesSet.end()
             ; ++state)
-        dynamicProgrammingStep.domainStates.push_back(*state);
-        
-    /*Use state colours to assign values to them.*/
-    for(unsigned int i = 0; i < dynamicProgrammingStep.domainStates.size(); ++i)
-        if(FRINGE == dynamicProgrammingStep.domainStates[i]->getColour())
-            dynamicProgrammingStep.domainStates[i]->setValue(expectedFringeReward);
-    
-    dynamicProgrammingStep.stateIds = map<eState*, int>();
-    
-    dynamicProgrammingStep.identifyStates();
-    
-    dynamicProgrammingStep.configurePolicy(*explDomSpec);
-
-    dynamicProgrammingStep.initialiseActions();
-    
-    dynamicProgrammingStep.configureActions(false);
-
-    dynamicProgrammingStep.initialiseValueVectors();
-    
-    /*Run Bellman backup, dynamic programming step, until
-      convergence.*/
-    while(!dynamicProgrammingStep())
-    {/*TODO:: Weaker stopping condition in the case of Value Iteration.*/};
- 
-    /*Update the values associated with domain states. Only values
-      associated with states coloured for deletion ($MARKED$) are
-      used.*/
-    dynamicProgrammingStep.updateStateValues();
-
-    /*Remove all transitions from newly explored states and colour
-      them as "having been explored".*/
-    for(unsigned int i = 0; i < dynamicProgrammingStep.domainStates.size(); ++i)
         {
-            if(EXPLICIT == dynamicProgrammingStep.domainStates[i]->getColour())
-                dynamicProgrammingStep.domainStates[i]->setColour(IMPLICIT);
+            if(EXPLICIT == (*state)->getColour())
+                (*state)->setColour(IMPLICIT);
         }
 
     /*Clean up memory from expansion.*/
@@ -21,7 +21,7 @@ using namespace MDP;
 
 /*Ensure all static variables are in scope.*/
 extern explicitDomainSpecification* ExpansionMemory::explicitDomSpec;
-extern unsigned int ExpansionMemory::peak;
+extern unsigned long long ExpansionMemory::peak;
 extern explicitDomainSpecification* ExpansionStates::explicitDomSpec;
 extern Algorithm* PolicyValue::algorithm;
 
@@ -46,16 +46,22 @@ ExpansionMemory::~ExpansionMemory()
 
 void ExpansionMemory::execute()
 {
+    /*The size of the states is mostly counted by the arena of the
+      domain as they are allocated (see
+      \method{explicitDomainSpecification::memory()}). The size is a
+      number of bytes, reported in Kb.*/
+    unsigned long long size = explicitDomSpec->memory() / 1000;
+
     cout<<"Domain Size :: "
-        <<explicitDomSpec->memory() / 1000
+        <<size
         <<" Kb.\n";
 
     /*Keep track of the largest memory usage, $peak$, to date.*/
-    if((explicitDomSpec->memory() / 1000) > peak)
-        peak = explicitDomSpec->memory() / 1000;
+    if(size > peak)
+        peak = size;
 }
 
-unsigned int ExpansionMemory::getPeak()const
+unsigned long long ExpansionMemory::getPeak()const
 {
     return peak;
 }
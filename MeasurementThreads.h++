@@ -22,6 +22,14 @@
  * threads\footnote{Or interval threads, because they report
  * accounting information at intervals.} (see \module{Thread} and
  * \module{StateBasedSolutionWrapper}).
+ *
+ * Measuring the number of states of a domain walks all its states,
+ * which perturbs the run being measured. So does measuring its
+ * memory, though only the proposition sets and label containers of
+ * the states are visited while the rest is counted by its
+ * \class{Arena} (see \module{StateBasedSolutionWrapper}). The
+ * probes of \module{Instrumentation} are updated by the solution
+ * methods themselves and are to be preferred for profiling.
  * */
 
 #ifndef MEASUREMENT_THREAD
@@ -58,10 +66,10 @@ namespace MDP
         static explicitDomainSpecification* explicitDomSpec;
 
         /*Largest memory usage to date.*/
-        unsigned int getPeak()const;
+        unsigned long long getPeak()const;
         
         /*Largest memory usage to date.*/
-        static unsigned int peak;
+        static unsigned long long peak;
     };
 
     /*This measurement thread measures the state size (number of
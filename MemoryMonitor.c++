@@ -43,6 +43,8 @@ private:
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
 
 PUBLIC MemoryMonitor::MemoryMonitor()
 {
@@ -50,6 +52,7 @@ PUBLIC MemoryMonitor::MemoryMonitor()
     reg->setFunction("monitorMemory", this, 1);
     reg->setFunction("stopMonitoringMemory", this, 0);
     reg->setFunction("peakMemoryUsage", this, 0);
+    reg->setFunction("peakResidentMemory", this, 0);
 }
 
 PUBLIC MemoryMonitor::~MemoryMonitor()
@@ -58,6 +61,7 @@ PUBLIC MemoryMonitor::~MemoryMonitor()
     reg->unregister("monitorMemory", this);
     reg->unregister("stopMonitoringMemory", this);
     reg->unregister("peakMemoryUsage", this);
+    reg->unregister("peakResidentMemory", this);
 
     if (isAlive())
         Destroy();
@@ -87,6 +91,22 @@ void MemoryMonitor::commandIssued(const string &command, const vector<string> &p
     if (command == "peakMemoryUsage") {
         commandResult = Utils::doubleToString(peakMemory - initialMemory);
     }
+    if (command == "peakResidentMemory") {
+        commandResult = Utils::doubleToString(peakResidentMemory());
+    }
+}
+
+PUBLIC double MemoryMonitor::peakResidentMemory()
+{
+    /* Kept by the kernel, thus no peak falls between samples. */
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        perror("Error reading resource usage");
+        return 0;
+    }
+    /* Linux reports the size in kilobytes. */
+    return usage.ru_maxrss / 1024.0;
 }
 
 PUBLIC double MemoryMonitor::currentMemoryUsage()
@@ -134,6 +154,8 @@ PUBLIC string MemoryMonitor::shortHelp(const string &command) const
         return shortHelpLine(command, "Stop periodically checking memory usage.");
     if (command == "peakMemoryUsage")
         return shortHelpLine(command, "Get largest memory used between starting and now (or stopping) in MB.");
+    if (command == "peakResidentMemory")
+        return shortHelpLine(command, "Get largest resident set size of the process so far in MB.");
     return "";
 }
 
@@ -17,6 +17,7 @@
 
 #include "PolicyIteration.h++"
 #include"domainSpecification_Anytime_or_Explicit.h++"
+#include"Instrumentation.h++"
 
 using namespace mtl;
 
@@ -244,6 +245,9 @@ bool PolicyIteration::operator()()
     ValueVector bestValue = ValueVector(domainStates.size());
     copy(thisIteration, bestValue);
     
+    /*Policy improvement backs up every state.*/
+    ScopedTimer timer(Instrumentation::bellmanBackup, domainStates.size());
+
     /*For each action.*/
     for(DenseActionMatrices::const_iterator action = actionMatrices.begin()
             ; action != actionMatrices.end()
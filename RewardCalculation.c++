@@ -19,6 +19,7 @@
 
 #include"rewardSpecification.h++"
 #include"EntailmentFilter.h++"
+#include"Instrumentation.h++"
 
 using namespace MDP;
 
@@ -27,6 +28,8 @@ double FLTLrewardCalculator::operator()
      const DomainSpecification::PropositionSet& propositions,
      BuildFilter<formula>* buildFilter)
 {
+    ScopedTimer timer(Instrumentation::rewardProgression);
+
     RewardSpecification* rewardSpec = *rewardSpecs.first;
     
     try{
@@ -43,6 +46,8 @@ double PLTLrewardCalculator::operator()
      const DomainSpecification::PropositionSet& propositions,
      BuildFilter<formula>* buildFilter)
 {
+    ScopedTimer timer(Instrumentation::rewardRegression);
+
     /*Reward associated with the caller states predecessor.*/
     RewardSpecification* predecessorRewardSpec = *rewardSpecs.first;
 
@@ -78,6 +83,10 @@ double PLTLrewardCalculator::operator()
     /*Configure the new reward specification according to the results
       of the $labelSetCopy$ traversal. Every specification that we
       traverse below _IS_ the same size.*/
+    /*The new reward specification shares canonical formulae where
+      a table is current.*/
+    FormulaTable* formulaTable = FormulaTable::getInstance();
+    
     RewardSpecification::const_iterator labelRegrElement;
     RewardSpecification::iterator rewardElement;
     RewardSpecification::const_iterator labelElement;
@@ -88,15 +97,26 @@ double PLTLrewardCalculator::operator()
             ; ++labelRegrElement, ++rewardElement, ++labelElement)
     {
         formula* tmp;
-        
+
         /*If the formula regresses to $false$.*/
-        if(assLiteral(false) == *labelRegrElement->second.form)
+        bool regressesToFalse = assLiteral(false) == *labelRegrElement->second.form;
+        
+        if(0 != formulaTable)
+        {
+            formula const* label = formulaTable->intern(labelElement->second.form);
+            
+            if(regressesToFalse)
+                label = formulaTable->negate(label);
+
+            tmp = const_cast<formula*>(label);
+        }
+        else if(regressesToFalse)
             tmp = new lnot(labelElement->second.form->copy());
         else/*Else the formula regressed to $true$.*/
             tmp = labelElement->second.form->copy();
 
         /*Delete the predecessor reward element*/
-        delete rewardElement->second.form;
+        RewardSpecification::releaseFormula(rewardElement->second.form);
 
         /*and replace it with the new calculated
           reward. Simplification should be of no use at this point.*/
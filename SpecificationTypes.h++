@@ -30,6 +30,8 @@
 #include<map>
 #include<algorithm>
 
+#include"Arena.h++"
+
 /*A colour for states which have been explored.*/
 #define EXPLICIT 2
 
@@ -81,9 +83,16 @@ namespace MDP
     /*State probability pair.*/
     typedef std::pair<double, State*> TransitionPair;
     
-    typedef std::vector<TransitionPair> ActionPossibilities;
+    /*Transitions are those of the explicit states (see
+     *\module{States}), they are allocated from the current
+     *\class{Arena} as they are part of the states that own them.*/
+    typedef std::vector<TransitionPair, ArenaAllocator<TransitionPair> > ActionPossibilities;
     
-    typedef std::map<action, ActionPossibilities> StateTransitionMatrices;
+    typedef std::map<action,
+                     ActionPossibilities,
+                     std::less<action>,
+                     ArenaAllocator<std::pair<const action, ActionPossibilities> > >
+    StateTransitionMatrices;
 };
 
 #endif
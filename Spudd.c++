@@ -21,6 +21,19 @@
  *
  * Applies the Spudd algorithm to a domain specification, which must
  * already be Markovian.
+ *
+ * In performance mode (see \method{enablePerformanceMode()}) the
+ * variables of the manager are ordered with each primed variable
+ * beside its unprimed variable, and the pairs are reordered by group
+ * sifting whenever the number of live nodes has doubled since the
+ * last reordering. The unique table and cache are allowed to grow
+ * in proportion to the diagrams of the domain. Optionally the value
+ * diagram is approximated after each iteration by merging leaves
+ * within a tolerance (APRICODD), the error of this approximation is
+ * added to \member{requiredDelta}. As in APRICODD the errors of the
+ * approximations are accumulated over the iterations, giving a bound
+ * on the distance of the value from that of exact value iteration
+ * (see \method{getApproximationError()}).
  */
 
 #include "common.h++"
@@ -56,6 +69,7 @@ private:
     ExtADD oldV;
     ExtADD v;
     ExtADD optimalValue; // valid when lastIteration
+    ExtADD maximum; // maximum of the last iteration, before approximation
     ExtADD policy;
     bool lastIteration;
     bool optimalComputed;
@@ -68,11 +82,19 @@ private:
     bool hideAssumptions;
 
     vector<double> deltaHistory;
+
+    // performance mode
+    bool performanceMode;
+    double tolerance;
+    double approximationError; // of the last approximation
+    double accumulatedError; // bound over all the approximations
+    unsigned int nextReordering;
 };
 
 #endif
 #include "Spudd.h++"
 #include "Utils.h++"
+#include "Instrumentation.h++"
 
 #include <algorithm>
 #include <set>
@@ -90,7 +112,12 @@ PUBLIC Spudd::Spudd(DomainSpecification& domSpec, ExtADD automaticConstraint,
       lastIteration(false),
       optimalComputed(false),
       combinedDualActionDiagrams(domSpec, constraint),
-      hideAssumptions(hideAssumptions)
+      hideAssumptions(hideAssumptions),
+      performanceMode(false),
+      tolerance(0.0),
+      approximationError(0.0),
+      accumulatedError(0.0),
+      nextReordering(0)
 {        
     vector<proposition> props = domSpec.getPropositions();
     numProps = props.size();
@@ -104,6 +131,7 @@ PUBLIC Spudd::Spudd(DomainSpecification& domSpec, ExtADD automaticConstraint,
 #endif
     
     v = reward;
+    maximum = v;
 
     iteration = 0;
 
@@ -114,7 +142,87 @@ PUBLIC Spudd::Spudd(DomainSpecification& domSpec, ExtADD automaticConstraint,
 PUBLIC void Spudd::setEpsilon(const double eps)
 {
     Algorithm::setEpsilon(eps);
-    requiredDelta = epsilon * (1 - gamma) / (2 * gamma);
+    requiredDelta = epsilon * (1 - gamma) / (2 * gamma) + approximationError;
+}
+
+/* Fewest live nodes at which the variables are reordered in
+ * performance mode. */
+static const unsigned int minimumReordering = 4096;
+
+/* Most unique table slots and cache entries asked for in performance
+ * mode. */
+static const unsigned long maximumTableSize = 1UL << 24;
+
+/* Order the variables so that each primed variable immediately
+ * follows its unprimed variable, and group each such pair so that
+ * reordering keeps them together.  Allow the unique table and cache
+ * to grow in proportion to the diagrams of the domain.  If
+ * `tolerance' is positive the value diagram is approximated after
+ * each iteration (see ExtADD::approximate()).
+ */
+PUBLIC void Spudd::enablePerformanceMode(double tolerance)
+{
+    DdManager *dd = mgr.getManager();
+
+    performanceMode = true;
+    this->tolerance = tolerance;
+
+    // every iteration multiplies the primed value diagram by the
+    // diagram of each action, so these determine the size of the
+    // tables
+    unsigned long nodes = reward.dagSize();
+    for (ActionADDmap::iterator i = combinedDualActionDiagrams.begin();
+         i != combinedDualActionDiagrams.end(); ++i)
+        nodes += i->second.dagSize();
+    unsigned int tableSize = min(maximumTableSize, nodes * 2 * numProps);
+
+    if (tableSize > Cudd_ReadLooseUpTo(dd))
+        Cudd_SetLooseUpTo(dd, tableSize);
+    if (tableSize > Cudd_ReadMaxCacheHard(dd))
+        Cudd_SetMaxCacheHard(dd, tableSize);
+
+    // the groups are only made once for a manager, they are kept by
+    // later runs along with the order found by them
+    if (0 == numProps || NULL != Cudd_ReadTree(dd)) {
+        nextReordering = max(minimumReordering, 2 * unsigned(Cudd_ReadNodeCount(dd)));
+        return;
+    }
+
+    // ensure that all the variables exist
+    mgr.addVar(2 * numProps - 1);
+
+    int size = Cudd_ReadSize(dd);
+    vector<int> permutation;
+    for (int i = 0; i < numProps; ++i) {
+        permutation.push_back(i);
+        permutation.push_back(i + numProps);
+    }
+    // any other variables follow in their current order
+    for (int level = 0; level < size; ++level)
+        if (Cudd_ReadInvPerm(dd, level) >= 2 * numProps)
+            permutation.push_back(Cudd_ReadInvPerm(dd, level));
+
+    if (!Cudd_ShuffleHeap(dd, &permutation[0])) {
+        cerr << "Spudd: variables could not be interleaved\n";
+        nextReordering = max(minimumReordering, 2 * unsigned(Cudd_ReadNodeCount(dd)));
+        return;
+    }
+
+    for (int i = 0; i < numProps; ++i)
+        Cudd_MakeTreeNode(dd, i, 2, MTR_FIXED);
+
+    Cudd_ReduceHeap(dd, CUDD_REORDER_GROUP_SIFT, 0);
+    nextReordering = max(minimumReordering, 2 * unsigned(Cudd_ReadNodeCount(dd)));
+}
+
+/* Bound on the greatest difference between a leaf of the value
+ * diagram and the value exact value iteration would have computed by
+ * the same iteration, or 0 if the diagram is not approximated.  Each
+ * iteration discounts the bound of the last and adds the greatest
+ * change made by its own approximation. */
+PUBLIC double Spudd::getApproximationError()
+{
+    return accumulatedError;
 }
 
 static Spudd *currentThis;
@@ -174,10 +282,11 @@ PUBLIC Diagram Spudd::getPolicy()
             operator()();
         } else {
             lastIteration = true;
-            optimalValue = v;
+            ExtADD current = v;
+            optimalValue = maximum;
             v = oldV;
             operator()();
-            v = optimalValue;
+            v = current;
             lastIteration = false;
             optimalComputed = false;
         }
@@ -255,6 +364,18 @@ PUBLIC bool Spudd::operator()()
     double deltaMax;
     if (!lastIteration)
         iteration++;
+
+    // reordering is not done within an iteration, as the policy is
+    // computed by an apply function that does not allow for it
+    if (performanceMode && unsigned(Cudd_ReadNodeCount(mgr.getManager())) > nextReordering) {
+        ScopedTimer reorderingTimer(Instrumentation::cuddReordering);
+        Cudd_ReduceHeap(mgr.getManager(), CUDD_REORDER_GROUP_SIFT, 0);
+        nextReordering = max(minimumReordering,
+                             2 * unsigned(Cudd_ReadNodeCount(mgr.getManager())));
+    }
+
+    ScopedTimer timer(Instrumentation::cuddOperation);
+
     oldV = v;
     ExtADD vPrime = v.primeRecursive(numProps);
 
@@ -298,6 +419,17 @@ PUBLIC bool Spudd::operator()()
         }
     }
 
+    // the policy is found where an action achieves the maximum
+    // exactly, thus the maximum is kept before approximation
+    if (!lastIteration) {
+        maximum = v;
+        if (0.0 < tolerance) {
+            v = v.approximate(tolerance, approximationError);
+            accumulatedError = gamma * accumulatedError + approximationError;
+            requiredDelta = epsilon * (1 - gamma) / (2 * gamma) + approximationError;
+        }
+    }
+
     ExtADD delta = v - oldV;
     ExtADD deltaMaxADD = delta.FindMax();
     deltaMax = deltaMaxADD.value();
@@ -321,7 +453,7 @@ PUBLIC bool Spudd::operator()()
         // know the maximum.  Instead we subtract our action values
         // from the known maximum, and where we get zeros, we set that
         // action in the optimal policy
-        optimalValue = v;
+        optimalValue = maximum;
         v = oldV;
         lastIteration = true;
         return false;
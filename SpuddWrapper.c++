@@ -59,6 +59,7 @@ PUBLIC SpuddWrapper::SpuddWrapper()
 {
     Registry *reg = Registry::getInstance();
     reg->setFunction("spudd", this, 2);
+    reg->setFunction("spudd", this, 3);
     reg->setFunction("spuddPolicyToDot", this, 0);
     reg->setFunction("spuddValueToDot", this, 0);
     reg->setFunction("spuddDeltaHistory", this, 0);
@@ -67,6 +68,7 @@ PUBLIC SpuddWrapper::SpuddWrapper()
     reg->setFunction("spuddValueDensity", this, 0);
     reg->setFunction("spuddValueNodes", this, 0);
     reg->setFunction("spuddValuePaths", this, 0);
+    reg->setFunction("spuddApproximationError", this, 0);
     reg->setFunction("clear", this, 0);
 }
 
@@ -87,6 +89,7 @@ PUBLIC SpuddWrapper::~SpuddWrapper()
     reg->unregister("spuddValueDensity", this);
     reg->unregister("spuddValueNodes", this);
     reg->unregister("spuddValuePaths", this);
+    reg->unregister("spuddApproximationError", this);
     reg->unregister("clear", this);
 }
 
@@ -125,6 +128,8 @@ void SpuddWrapper::commandIssued(const string &command, const vector<string> &pa
         double discount = atof(parameters[0].c_str());
         double epsilon = atof(parameters[1].c_str());
         spudd = new Spudd(*ci->getDomSpec(), ci->getAutomaticConstraint(), discount, epsilon, hideAssumptions);
+        if (parameters.size() > 2)
+            spudd->enablePerformanceMode(atof(parameters[2].c_str()));
     } else if (command == "clear") {
         if (spudd != NULL) {
             delete spudd;
@@ -166,13 +171,16 @@ void SpuddWrapper::commandIssued(const string &command, const vector<string> &pa
         if (command == "spuddValuePaths") {
             commandResult = Utils::doubleToString(spudd->getOptValPaths(), 0);
         }
+        if (command == "spuddApproximationError") {
+            commandResult = Utils::doubleToString(spudd->getApproximationError());
+        }
     }
 }
 
 string SpuddWrapper::shortHelp(const string &command) const
 {
     if (command == "spudd")
-        return shortHelpLine(command + "(d,e)", "SPUDD algorithm with `d' discount, `e' epsilon");
+        return shortHelpLine(command + "(d,e[,t])", "SPUDD algorithm with `d' discount, `e' epsilon, `t' tolerance (optional)");
     if (command == "spuddPolicyToDot")
         return shortHelpLine(command, "Return the current policy as a dot graph.");
     if (command == "spuddValueToDot")
@@ -189,6 +197,8 @@ string SpuddWrapper::shortHelp(const string &command) const
         return shortHelpLine(command, "The number of nodes in the optimal value ADD.");
     if (command == "spuddValuePaths")
         return shortHelpLine(command, "The number of paths in the optimal value ADD.");
+    if (command == "spuddApproximationError")
+        return shortHelpLine(command, "Bound on the error of the value ADD due to approximation.");
     return "";
 }
 
@@ -197,9 +207,17 @@ string SpuddWrapper::longHelp(const string &command) const
     if (command == "spudd") {
         return shortHelp(command) + "\n" + Utils::wordWrapString(
             helpIndentSize,
-            "This command takes two parameters:  \n"
+            "This command takes two or three parameters:  \n"
             "  arg1 : discount factor\n"
             "  arg2 : epsilon\n"
+            "  arg3 : tolerance (optional)\n"
+            "Given a tolerance, Spudd runs in performance mode.  Primed and unprimed variables "
+            "are kept adjacent while the variables are reordered by group sifting, and the "
+            "unique table and cache are sized from the domain.  If the tolerance is positive, "
+            "leaves of the value ADD within the tolerance of each other are merged after each "
+            "iteration, and the resulting error is added to the convergence threshold.  "
+            "The spuddApproximationError command gives a bound on the error of the values "
+            "accumulated over these merges.  "
             "The domain specification should be Markovian before calling this.  "
             "See the PLTLvarExpand command for how to make the domain specification Markovian.  ");
     }
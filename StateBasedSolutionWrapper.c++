@@ -42,10 +42,32 @@
  * \item{\textbf{polIt:}} Interface to the \class{PolicyIteration}
  * \class{Algorithm}.
  *
+ * Both \textbf{valIt} and \textbf{polIt} take an optional backend
+ * argument. The backend $csr$ selects the
+ * \class{CompressedValueIteration} and
+ * \class{CompressedPolicyIteration} respectively, these are also
+ * available to \textbf{LAO} as $csrValIt$ and $csrPolIt$. The
+ * \textbf{LAO} algorithm $incValIt$ is the
+ * \class{IncrementalValueIteration}, which is not restarted on each
+ * expansion.
+ *
+ * \item{\textbf{saveDomain}:} Writes the expanded domain, its values
+ * and policy to a \class{DomainImage}.
+ *
+ * \item{\textbf{loadDomain}:} Maps a \class{DomainImage}. The backend
+ * $image$ of \textbf{valIt} and \textbf{polIt} solves the domain of
+ * the image, without expansion. No domain need be loaded to solve an
+ * image, the \member{explicitDomSpec} is not constructed for it.
+ *
  * \item{\textbf{simplify}:} Removes all impossible states (including
  * states which lead to an impossibility) from the
  * \member{explicitDomSpec}.
  *
+ * \item{\textbf{arenaAllocation}:} Whether the states of the next
+ * \member{explicitDomSpec} are allocated from an \class{Arena} (the
+ * default) or on the heap, so that the effect of the arena can be
+ * measured.
+ *
  * \end{itemize}
  *
  * Also included in this module is the user interface to the
@@ -64,6 +86,7 @@
 #include"SpecificationTypes.h++"
 #include"AlgorithmTypes.h++"
 #include"Timer.h++"
+#include"DomainImage.h++"
 
 /*Interval reportage inclusive.*/
 #include"MeasurementThreads.h++"
@@ -88,11 +111,39 @@ private:
     /*This wrapper provides an interface to \class{ValueIteration}
      *\class{Algorithm}.*/
     ValueIteration* valIt;
+
+    /*This wrapper provides an interface to search driven
+     *\class{CompressedPolicyIteration}.*/
+    LAO<CompressedPolicyIteration>* laoCompressedPi;
+
+    /*This wrapper provides an interface to search driven
+     *\class{CompressedValueIteration}.*/
+    LAO<CompressedValueIteration>* laoCompressedVi;
+
+    /*This wrapper provides an interface to search driven
+     *\class{IncrementalValueIteration}.*/
+    LAO<IncrementalValueIteration>* laoIncrementalVi;
+
+    /*This wrapper provides an interface to
+     *\class{CompressedPolicyIteration} \class{Algorithm}.*/
+    CompressedPolicyIteration* compressedPolIt;
+
+    /*This wrapper provides an interface to
+     *\class{CompressedValueIteration} \class{Algorithm}.*/
+    CompressedValueIteration* compressedValIt;
     
     /*An \class{explicitDomainSpecification} based on the
      *\class{CommandInterpreter}s \member{domSpec}.*/
     explicitDomainSpecification* explicitDomSpec;
 
+    /*Image of an expanded domain mapped by the \textbf{loadDomain}
+     *command.*/
+    DomainImage domainImage;
+
+    /*Are \member{compressedValIt} or \member{compressedPolIt}
+     *solving the \member{domainImage}?*/
+    bool imageSolution;
+
     /*Utility for estimating the algorithms execution time.*/
     Timer timer;
 
@@ -122,6 +173,12 @@ private:
     /*Time that the \member{timer} reported when it was last reset.*/
     double timeCache;
 
+    /*For each iteration of the current solution algorithm, the time
+     *that the \member{timer} reported at the end of the iteration and
+     *the error (see \member{Algorithm.getError()}) of the algorithm
+     *after the iteration.*/
+    vector<pair<double, double> > errorHistory;
+
     /*Handle to what this interface believes to be the applications
      *domain specification. If the application specification changes
      *then \ember{domSpec} becomes inconsistent and is updated.*/
@@ -133,6 +190,10 @@ private:
      *If true, simplification will remove states which are impossible
      *to reach according to control knowledge.*/
     bool alwaysSimplify;
+
+    /*Are the states of the \member{explicitDomSpec} allocated from an
+     *\class{Arena}? Applies to the next domain constructed.*/
+    bool arenaAllocation;
 };
 
 #endif
@@ -147,6 +208,8 @@ private:
 #include"LAO.h++"
 #include"ValueIteration.h++"
 #include"PolicyIteration.h++"
+#include"CompressedValueIteration.h++"
+#include"CompressedPolicyIteration.h++"
 
 #include<sstream>
 #include<cstdlib>
@@ -167,7 +230,8 @@ using namespace std;
  *initialised with the functionality provided by this
  *\class{CommandListener}.
  *
- *\item \member{polIt} and \member{valIt} are both initialised to $0$.
+ *\item \member{polIt} and \member{valIt} are both initialised to
+ *$0$, as are their compressed counterparts.
  *
  *\item All pointers to accounting threads are initialised to $0$.
  *
@@ -185,14 +249,21 @@ PUBLIC StateBasedSolutionWrapper::StateBasedSolutionWrapper()
      laoVi(0),
      polIt(0),
      valIt(0),
+     laoCompressedPi(0),
+     laoCompressedVi(0),
+     laoIncrementalVi(0),
+     compressedPolIt(0),
+     compressedValIt(0),
      explicitDomSpec(0),
+     imageSolution(false),
      expansionMemory(0),
      expansionStates(0),
      policyAccounting(0),
      valueDifference(0),
      timeCache(0),
      domSpec(0),
-     alwaysSimplify(false)
+     alwaysSimplify(false),
+     arenaAllocation(true)
 {
     Registry *reg = Registry::getInstance();
     
@@ -200,13 +271,19 @@ PUBLIC StateBasedSolutionWrapper::StateBasedSolutionWrapper()
     reg->setFunction("LAO", this, 2);
     reg->setFunction("expand", this, 0);
     reg->setFunction("preprocess", this, 1);
+    reg->setFunction("valIt", this, 3);
     reg->setFunction("valIt", this, 2);
+    reg->setFunction("polIt", this, 2);
     reg->setFunction("polIt", this, 1);
     reg->setFunction("simplify", this, 0);
     reg->setFunction("alwaysSimplify", this, 1);
+    reg->setFunction("arenaAllocation", this, 1);
+    reg->setFunction("saveDomain", this, 1);
+    reg->setFunction("loadDomain", this, 1);
 
     reg->setFunction("valueDifferenceAtInterval", this, 1);
     reg->setFunction("valueDifference", this, 0);
+    reg->setFunction("errorHistory", this, 0);
     reg->setFunction("printDomain", this, 1);
     reg->setFunction("iterationCount", this, 0);
     reg->setFunction("iterationCount", this, 1);
@@ -214,6 +291,7 @@ PUBLIC StateBasedSolutionWrapper::StateBasedSolutionWrapper()
     reg->setFunction("averageLabelSize", this, 0);
     reg->setFunction("domainStateSize", this, 0);
     reg->setFunction("domainMemorySize", this, 0);
+    reg->setFunction("domainAllocations", this, 0);
     reg->setFunction("expansionMemory", this, 1);
     reg->setFunction("expansionStates", this, 1);
     reg->setFunction("expansionPeak", this, 0);
@@ -236,12 +314,18 @@ PUBLIC StateBasedSolutionWrapper::~StateBasedSolutionWrapper()
     reg->unregister("expand", this);
     reg->unregister("preprocess", this);
     reg->unregister("valIt", this);
+    reg->unregister("valIt", this);
+    reg->unregister("polIt", this);
     reg->unregister("polIt", this);
     reg->unregister("simplify", this);
     reg->unregister("alwaysSimplify", this);
+    reg->unregister("arenaAllocation", this);
+    reg->unregister("saveDomain", this);
+    reg->unregister("loadDomain", this);
 
     reg->unregister("valueDifferenceAtInterval", this);
     reg->unregister("valueDifference", this);
+    reg->unregister("errorHistory", this);
     reg->unregister("printDomain", this);
     reg->unregister("iterationCount", this);
     reg->unregister("iterationCount", this);
@@ -249,6 +333,7 @@ PUBLIC StateBasedSolutionWrapper::~StateBasedSolutionWrapper()
     reg->unregister("averageLabelSize", this);
     reg->unregister("domainStateSize", this);
     reg->unregister("domainMemorySize", this);
+    reg->unregister("domainAllocations", this);
     reg->unregister("expansionMemory", this);
     reg->unregister("expansionStates", this);
     reg->unregister("expansionPeak", this);
@@ -277,11 +362,57 @@ PRIVATE void StateBasedSolutionWrapper::clearSolutionAlgorithms()
     delete polIt;
     delete laoVi;
     delete laoPi;
+    delete compressedValIt;
+    delete compressedPolIt;
+    delete laoCompressedVi;
+    delete laoCompressedPi;
+    delete laoIncrementalVi;
     
     valIt = 0;
     polIt = 0;
     laoVi = 0;
     laoPi = 0;
+    compressedValIt = 0;
+    compressedPolIt = 0;
+    laoCompressedVi = 0;
+    laoCompressedPi = 0;
+    laoIncrementalVi = 0;
+
+    imageSolution = false;
+}
+
+/*Give the states of the \member{explicitDomSpec} the values of the
+ *current solution algorithm, where that algorithm does not do so
+ *itself.*/
+PRIVATE void StateBasedSolutionWrapper::updateStateValues()
+{
+    if(imageSolution)
+        return;
+
+    if(0 != valIt)
+        valIt->updateStateValues();
+    else if(0 != polIt)
+        polIt->updateStateValues();
+    else if(0 != compressedValIt)
+        compressedValIt->updateStateValues();
+    else if(0 != compressedPolIt)
+        compressedPolIt->updateStateValues();
+}
+
+/*The current solution algorithm, $0$ if there is none.*/
+PRIVATE Algorithm* StateBasedSolutionWrapper::getAlgorithm()const
+{
+    if(laoPi != 0)return dynamic_cast<Algorithm*>(laoPi);
+    else if(laoVi != 0)return dynamic_cast<Algorithm*>(laoVi);
+    else if(valIt != 0)return dynamic_cast<Algorithm*>(valIt);
+    else if(polIt != 0)return dynamic_cast<Algorithm*>(polIt);
+    else if(laoCompressedPi != 0)return dynamic_cast<Algorithm*>(laoCompressedPi);
+    else if(laoCompressedVi != 0)return dynamic_cast<Algorithm*>(laoCompressedVi);
+    else if(laoIncrementalVi != 0)return dynamic_cast<Algorithm*>(laoIncrementalVi);
+    else if(compressedValIt != 0)return dynamic_cast<Algorithm*>(compressedValIt);
+    else if(compressedPolIt != 0)return dynamic_cast<Algorithm*>(compressedPolIt);
+
+    return 0;
 }
 
 /*Delete and nullify any measurment thread objects.*/
@@ -324,6 +455,12 @@ bool StateBasedSolutionWrapper::commandIteration(const string &command)
             stoppingCondition = (*laoVi)();
         else if(0 != laoPi)
             stoppingCondition =  (*laoPi)();
+        else if(0 != laoCompressedVi)
+            stoppingCondition = (*laoCompressedVi)();
+        else if(0 != laoCompressedPi)
+            stoppingCondition = (*laoCompressedPi)();
+        else if(0 != laoIncrementalVi)
+            stoppingCondition = (*laoIncrementalVi)();
 
         /*Destroy all accounting threads if expansion and solution is
          *complete.*/
@@ -378,14 +515,17 @@ bool StateBasedSolutionWrapper::commandIteration(const string &command)
     {
         explicitDomSpec->removeImpossibleStates();
     }
-    else if(command == "polIt" && 0 != polIt)
+    else if(command == "polIt" && (0 != polIt || 0 != compressedPolIt))
     {
         /*The \member{valueDifference} is only alive and non--null when a
           solution algorithm is present/requested.*/
         if(0 != valueDifference && !valueDifference->isAlive())
             valueDifference->Create();
         
-        stoppingCondition = (*polIt)();
+        if(0 != polIt)
+            stoppingCondition = (*polIt)();
+        else
+            stoppingCondition = (*compressedPolIt)();
         
         /*Ensure that the \member{valueDifference} does not recommence until
           the user requests this.*/
@@ -395,14 +535,17 @@ bool StateBasedSolutionWrapper::commandIteration(const string &command)
             valueDifference = 0;
         }
     }
-    else if(command == "valIt" && 0 != valIt)
+    else if(command == "valIt" && (0 != valIt || 0 != compressedValIt))
     {
         /*The \member{valueDifference} is only alive and non--null when a
           solution algorithm is present/requested.*/
         if(0 != valueDifference && !valueDifference->isAlive())
             valueDifference->Create();
         
-        stoppingCondition = (*valIt)();
+        if(0 != valIt)
+            stoppingCondition = (*valIt)();
+        else
+            stoppingCondition = (*compressedValIt)();
         
         /*Ensure that the \member{valueDifference} does not recommence until
           the user requests this.*/
@@ -414,6 +557,11 @@ bool StateBasedSolutionWrapper::commandIteration(const string &command)
     }
     stopTimer();
 
+    /*Record the progress of the solution algorithm.*/
+    if((command == "LAO" || command == "valIt" || command == "polIt")
+       && 0 != getAlgorithm())
+        errorHistory.push_back(pair<double, double>(getTimerTime(),
+                                                    getAlgorithm()->getError()));
     
     /*We have done one more iteration of the solution algorithm.*/
     iterations++;
@@ -432,7 +580,34 @@ PRIVATE void StateBasedSolutionWrapper::configureExplicitDomainSpecification()
     ci->getDomSpec()->getRewardSpecification()->simplify();
         //ci->getDomSpec()->getRewardSpecification()->checkDuplication();
     domSpec = ci->getDomSpec();
-    explicitDomSpec = new explicitDomainSpecification(*ci->getDomSpec());
+    explicitDomSpec = new explicitDomainSpecification(*ci->getDomSpec(), arenaAllocation);
+}
+
+/*Does the argument command need the \member{explicitDomSpec}? Those
+ *that load, solve and query a \class{DomainImage}, or that only
+ *report on the current algorithm, do not.*/
+PRIVATE bool StateBasedSolutionWrapper::requiresExplicitDomain(const string &command,
+                                                               const vector<string> &parameters)const
+{
+    if(command == "loadDomain"
+       || command == "arenaAllocation"
+       || command == "clear"
+       || command == "errorHistory"
+       || command == "valueDifference"
+       || command == "iterationCount"
+       || command == "reportTime")
+        return false;
+
+    if(command == "valIt")
+        return !(3 <= parameters.size() && "image" == parameters[2]);
+
+    if(command == "polIt")
+        return !(2 <= parameters.size() && "image" == parameters[1]);
+
+    if(command == "saveDomain" || command == "getPolicy")
+        return !imageSolution;
+
+    return true;
 }
 
 /*See \parent{CommandListener}.*/
@@ -450,8 +625,8 @@ void StateBasedSolutionWrapper::commandIssued(const string &command, const vecto
     /*Commands*/
     
     /*If the explicit domain specification has not yet been
-      constructed.*/
-    if(0 == explicitDomSpec)
+      constructed, and is needed.*/
+    if(0 == explicitDomSpec && requiresExplicitDomain(command, parameters))
         configureExplicitDomainSpecification();
 
     if (command == "simplify" || command == "expand")
@@ -461,6 +636,7 @@ void StateBasedSolutionWrapper::commandIssued(const string &command, const vecto
     else if (command == "LAO")
     {
         clearSolutionAlgorithms();
+        errorHistory.clear();
 
         double gamma = atof(parameters[1].c_str());
         double epsilon;
@@ -479,6 +655,21 @@ void StateBasedSolutionWrapper::commandIssued(const string &command, const vecto
             laoPi = new LAO<PolicyIteration>(*explicitDomSpec, gamma, epsilon, alwaysSimplify);
             acceptLastCommand = true;
         }
+        else if("csrValIt" == parameters[0])
+        {
+            laoCompressedVi = new LAO<CompressedValueIteration>(*explicitDomSpec, gamma, epsilon, alwaysSimplify);
+            acceptLastCommand = true;
+        }
+        else if("csrPolIt" == parameters[0])
+        {
+            laoCompressedPi = new LAO<CompressedPolicyIteration>(*explicitDomSpec, gamma, epsilon, alwaysSimplify);
+            acceptLastCommand = true;
+        }
+        else if("incValIt" == parameters[0])
+        {
+            laoIncrementalVi = new LAO<IncrementalValueIteration>(*explicitDomSpec, gamma, epsilon, alwaysSimplify);
+            acceptLastCommand = true;
+        }
     }
     else if(command == "rewardDuplication")
     {
@@ -548,19 +739,104 @@ void StateBasedSolutionWrapper::commandIssued(const string &command, const vecto
     else if(command == "polIt")
     {
         clearSolutionAlgorithms();
+        errorHistory.clear();
 
         double gamma = atof(parameters[0].c_str());
-        polIt = new PolicyIteration(*explicitDomSpec, gamma, 0.1);
-        acceptLastCommand = true;
+
+        if(parameters.size() < 2 || "mtl" == parameters[1])
+        {
+            polIt = new PolicyIteration(*explicitDomSpec, gamma, 0.1);
+            acceptLastCommand = true;
+        }
+        else if("csr" == parameters[1])
+        {
+            compressedPolIt = new CompressedPolicyIteration(*explicitDomSpec, gamma, 0.1);
+            acceptLastCommand = true;
+        }
+        else if("image" == parameters[1])
+        {
+            if(domainImage.isOpen())
+            {
+                compressedPolIt = new CompressedPolicyIteration(domainImage,
+                                                                *CommandInterpreter::getInstance()->getDomSpec(),
+                                                                gamma,
+                                                                0.1);
+                imageSolution = true;
+                acceptLastCommand = true;
+            }
+            else
+                cerr<<"A domain image must be loaded (see \"loadDomain\").\n";
+        }
     }
     else if(command == "valIt")
     {
         clearSolutionAlgorithms();
+        errorHistory.clear();
         
         double gamma = atof(parameters[0].c_str());
         double epsilon = atof(parameters[1].c_str());
-        valIt = new ValueIteration(*explicitDomSpec, gamma, epsilon);
-        acceptLastCommand = true;
+
+        if(parameters.size() < 3 || "mtl" == parameters[2])
+        {
+            valIt = new ValueIteration(*explicitDomSpec, gamma, epsilon);
+            acceptLastCommand = true;
+        }
+        else if("csr" == parameters[2])
+        {
+            compressedValIt = new CompressedValueIteration(*explicitDomSpec, gamma, epsilon);
+            acceptLastCommand = true;
+        }
+        else if("image" == parameters[2])
+        {
+            if(domainImage.isOpen())
+            {
+                compressedValIt = new CompressedValueIteration(domainImage,
+                                                               *CommandInterpreter::getInstance()->getDomSpec(),
+                                                               gamma,
+                                                               epsilon);
+                imageSolution = true;
+                acceptLastCommand = true;
+            }
+            else
+                cerr<<"A domain image must be loaded (see \"loadDomain\").\n";
+        }
+    }
+    else if(command == "saveDomain")
+    {
+        bool saved;
+
+        if(imageSolution && 0 != compressedValIt)
+            saved = domainImage.save(parameters[0],
+                                     compressedValIt->getValues(),
+                                     compressedValIt->getChoices());
+        else if(imageSolution && 0 != compressedPolIt)
+            saved = domainImage.save(parameters[0],
+                                     compressedPolIt->getValues(),
+                                     compressedPolIt->getChoices());
+        else
+        {
+            updateStateValues();
+            saved = DomainImage::save(parameters[0], *explicitDomSpec);
+        }
+
+        if(saved)
+            acceptLastCommand = true;
+        else
+            cerr<<"The domain could not be written to \""<<parameters[0]<<"\".\n";
+    }
+    else if(command == "loadDomain")
+    {
+        /*Algorithms solving the old image are deleted with it.*/
+        if(imageSolution)
+            clearSolutionAlgorithms();
+
+        if(domainImage.open(parameters[0]))
+        {
+            streamCommandResult<<"The domain image is comprised of "
+                               <<domainImage.numberOfStates()<<" e-states and "
+                               <<domainImage.numberOfTransitions()<<" transitions.\n";
+            acceptLastCommand = true;
+        }
     }
     else if(command == "alwaysSimplify")/*Simplify during expansion?*/
     {
@@ -570,6 +846,11 @@ void StateBasedSolutionWrapper::commandIssued(const string &command, const vecto
             alwaysSimplify = false;
         acceptLastCommand = true;
     }
+    else if(command == "arenaAllocation")/*Pool the states?*/
+    {
+        arenaAllocation = ("true" == parameters[0]);
+        acceptLastCommand = true;
+    }
     
     /*Queries*/
     else if(command == "printDomain")
@@ -606,10 +887,32 @@ void StateBasedSolutionWrapper::commandIssued(const string &command, const vecto
         else if(valIt != 0)streamCommandResult<<valIt->getError()<<endl;
         
         else if(polIt != 0)streamCommandResult<<polIt->getError()<<endl;
+
+        else if(laoCompressedPi != 0)streamCommandResult<<laoCompressedPi->getError()<<endl;
+
+        else if(laoCompressedVi != 0)streamCommandResult<<laoCompressedVi->getError()<<endl;
+
+        else if(laoIncrementalVi != 0)streamCommandResult<<laoIncrementalVi->getError()<<endl;
+
+        else if(compressedValIt != 0)streamCommandResult<<compressedValIt->getError()<<endl;
+
+        else if(compressedPolIt != 0)streamCommandResult<<compressedPolIt->getError()<<endl;
         
         streamCommandResult<<"\n";
         acceptLastCommand = true;
     }
+    else if(command == "errorHistory")
+    {
+        for(vector<pair<double, double> >::const_iterator entry = errorHistory.begin()
+                ; entry != errorHistory.end()
+                ; ++entry)
+        {
+            if(entry != errorHistory.begin())
+                streamCommandResult<<',';
+            streamCommandResult<<entry->first<<':'<<entry->second;
+        }
+        acceptLastCommand = true;
+    }
     else if(command == "iterationCount")
     {
         if(parameters.size() == 0 || parameters[0] == "")
@@ -634,11 +937,20 @@ void StateBasedSolutionWrapper::commandIssued(const string &command, const vecto
     }
     else if(command == "domainMemorySize")
     {
+         /*The memory of a domain is a number of bytes.*/
          streamCommandResult<<"The domain is currently "
                             <<explicitDomSpec->memory() / 1000
                             <<" Kb in size.\n";
          acceptLastCommand = true;
     }
+    else if(command == "domainAllocations")
+    {
+         if(0 != explicitDomSpec->getArena())
+             streamCommandResult<<explicitDomSpec->getArena()->report();
+         else
+             streamCommandResult<<"The domain is allocated on the heap.\n";
+         acceptLastCommand = true;
+    }
     else if(command == "domainStateSize")
     {
          streamCommandResult<<"The domain is currently comprised of "
@@ -686,12 +998,20 @@ void StateBasedSolutionWrapper::commandIssued(const string &command, const vecto
     }
     else if(command == "getPolicy")
     {
-        streamCommandResult<<explicitDomSpec->policyToString();
+        if(imageSolution && 0 != compressedValIt)
+            streamCommandResult<<domainImage.policyToString(compressedValIt->getChoices());
+        else if(imageSolution && 0 != compressedPolIt)
+            streamCommandResult<<domainImage.policyToString(compressedPolIt->getChoices());
+        else
+            streamCommandResult<<explicitDomSpec->policyToString();
         acceptLastCommand = true;
     }
     else if(command == "clear")
     {
         clearSolutionAlgorithms();
+        errorHistory.clear();
+
+        domainImage.close();
         
         delete  explicitDomSpec;
         explicitDomSpec = 0;
@@ -713,11 +1033,7 @@ void StateBasedSolutionWrapper::commandIssued(const string &command, const vecto
             valueDifference = 0;
         }
         
-        Algorithm* algorithm = 0;
-        if(laoPi != 0)algorithm = dynamic_cast<Algorithm*>(laoPi);
-        else if(laoVi != 0)algorithm = dynamic_cast<Algorithm*>(laoVi);
-        else if(valIt != 0)algorithm = dynamic_cast<Algorithm*>(valIt);
-        else if(polIt != 0)algorithm = dynamic_cast<Algorithm*>(polIt);   
+        Algorithm* algorithm = getAlgorithm();
         
         /*If an algorithm has been requested.*/
         if(0 != algorithm)
@@ -752,6 +1068,9 @@ string StateBasedSolutionWrapper::shortHelp(const string &command) const
     else if(command == "simplify")
         result = shortHelpLine(command, string("Simplify the expanded domain. This removes states which are\n")
             + shortHelpLine("", "impossible and predecessors of those which are impossible.\n"));
+    else if(command == "arenaAllocation")
+        result = shortHelpLine(command, string("Allocate the states of the next expanded domain from an arena if the\n")
+            + shortHelpLine("", "argument is \"true\" (the default), or on the heap if it is \"false\".\n"));
     else if(command == "alwaysSimplify")
         result = shortHelpLine(command, string("Simplify the expanded domain during expansion. By executing this\n")
             + shortHelpLine("", "command before the \"expand\" command, expansion shall consider\n")
@@ -763,6 +1082,16 @@ string StateBasedSolutionWrapper::shortHelp(const string &command) const
     else if(command == "valueDifference")
         result = shortHelpLine(command, string("Reports the supremum norm between the current less the previous\n")
             + shortHelpLine("", "value vector.\n"));
+    else if(command == "saveDomain")
+        result = shortHelpLine(command, string("Writes the expanded domain, with the values and policy of the last\n")
+            + shortHelpLine("", "executed solution algorithm, to a binary domain image.\n"));
+    else if(command == "loadDomain")
+        result = shortHelpLine(command, string("Maps a domain image written by \"saveDomain\", which may then be\n")
+            + shortHelpLine("", "solved with the \"image\" backend of \"valIt\" and \"polIt\".\n"));
+    else if(command == "errorHistory")
+        result = shortHelpLine(command, string("Reports, for each iteration of the last executed solution algorithm,\n")
+            + shortHelpLine("", "the time at which it ended and the supremum norm of the current less\n")
+            + shortHelpLine("", "the previous value vector, as comma separated time:error pairs.\n"));
     else if(command == "printDomain")
         result = shortHelpLine(command, string("Returns a textual description of the current XMDP or NMRDP domain\n")
             + shortHelpLine("", "depending on whether the argument is \"MDP\" or \"NMRDP\" respectively.\n"));
@@ -777,6 +1106,8 @@ string StateBasedSolutionWrapper::shortHelp(const string &command) const
         result = shortHelpLine(command, string("Reports the number of states in the XMDP.\n"));
     else if(command == "domainMemorySize")
         result = shortHelpLine(command, string("Reports the number of Kb used by the current XMDP."));
+    else if(command == "domainAllocations")
+        result = shortHelpLine(command, string("Reports the blocks and bytes allocated by the current XMDP.\n"));
     else if(command == "expansionMemory")
         result = shortHelpLine(command, string("Reports the number of Kb used by the current XMDP at $n$\n")
             + shortHelpLine("", "second intervals where $n$ is an unsigned integer argument.\n"));
@@ -819,7 +1150,11 @@ string StateBasedSolutionWrapper::longHelp(const string &command) const
                                         "in the case where the reward specification is given in FLTL.\n");
 
     else if(command == "LAO")
-        result += Utils::wordWrapString(helpIndentSize, "\t arg1 :: Algorithm used for Bellman backup (valIt, polIt).\n\n"
+        result += Utils::wordWrapString(helpIndentSize, "\t arg1 :: Algorithm used for Bellman backup (valIt, polIt, "
+                                        "csrValIt, csrPolIt, incValIt). The \"csr\" algorithms store the explicit graph "
+                                        "in compressed sparse rows. \"incValIt\" keeps its values and compressed sparse "
+                                        "rows from one expansion to the next, and only backs up states whose values "
+                                        "may have changed.\n\n"
                                         "\t arg2 :: Discount factor (gamma).\n\n"
                                         "\t arg3 :: Value iteration shall terminate when the computed value "
                                         "function is within $arg3/2$ of the optimal. This argument is optional if "
@@ -827,10 +1162,46 @@ string StateBasedSolutionWrapper::longHelp(const string &command) const
     else if(command == "valIt")
         result += Utils::wordWrapString(helpIndentSize, "\t arg1 :: Discount factor (gamma).\n"
                                         "\t arg2 :: Value iteration shall terminate when the computed value "
-                                        "function is within $arg2/2$ of the optimal.\n");
+                                        "function is within $arg2/2$ of the optimal.\n"
+                                        "\t arg3 :: Optional backend, either \"mtl\" (the default) for sparse "
+                                        "matrices per action or \"csr\" for compressed sparse rows with a fused "
+                                        "backup over all actions. The \"image\" backend is \"csr\" over the "
+                                        "domain image of the last \"loadDomain\".\n");
     else if(command == "polIt")
-        result += Utils::wordWrapString(helpIndentSize, "\t arg1 :: Discount factor (gamma).\n\n");
-    
+        result += Utils::wordWrapString(helpIndentSize, "\t arg1 :: Discount factor (gamma).\n\n"
+                                        "\t arg2 :: Optional backend, either \"mtl\" (the default) for dense LU "
+                                        "policy evaluation or \"csr\" for Gauss--Seidel policy evaluation over "
+                                        "compressed sparse rows. The \"image\" backend is \"csr\" over the "
+                                        "domain image of the last \"loadDomain\", starting from the policy of "
+                                        "the image. Without discounting, a \"csr\" evaluation makes at most 10000 "
+                                        "sweeps as the values of a policy need not converge.\n\n");
+    else if(command == "saveDomain")
+        result += Utils::wordWrapString(helpIndentSize, "\t arg1 :: Name of the file to write.\n\n"
+                                        "The image holds the states, their propositions, reward labels, rewards, "
+                                        "values and colours, the transitions and the policy. Where the last solution "
+                                        "algorithm solved a loaded image, that image is written with the new values "
+                                        "and policy.\n");
+    else if(command == "loadDomain")
+        result += Utils::wordWrapString(helpIndentSize, "\t arg1 :: Name of an image file written by \"saveDomain\".\n\n"
+                                        "The file is mapped rather than read, thus loading takes the same time "
+                                        "whatever the size of the domain. Reward labels are kept as text, the "
+                                        "image cannot be expanded further.\n");
+    else if(command == "domainMemorySize" || command == "domainAllocations")
+        result += Utils::wordWrapString(helpIndentSize, "The states of the XMDP, their transitions and labels "
+                                        "are allocated from an arena owned by the XMDP, which counts the blocks "
+                                        "it allocates. \"domainAllocations\" reports only these blocks, the bytes "
+                                        "the arena has taken from the heap, and the number of allocations since "
+                                        "the XMDP was constructed. The proposition sets of the states and the "
+                                        "containers of their labels are on the heap, thus \"domainMemorySize\" "
+                                        "visits the states to estimate them and adds them to the blocks of the "
+                                        "arena. Where the arena is turned off (see \"arenaAllocation\") the whole "
+                                        "of each state is estimated instead, thus the sizes are comparable but "
+                                        "not equal.\n");
+    else if(command == "errorHistory")
+        result += Utils::wordWrapString(helpIndentSize, "Times are the processor time, in seconds, spent by the "
+                                        "\"LAO\", \"valIt\" or \"polIt\" command up to the end of the iteration. "
+                                        "The history is restarted whenever one of these commands is issued.\n");
+
     return result;
 }
 
@@ -0,0 +1,543 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include<cstring>
+
+#include"StateStore.h++"
+
+#include"States.h++"
+#include"rewardSpecification.h++"
+#include"Instrumentation.h++"
+
+using namespace MDP;
+
+/*Number of proposition bits in a word.*/
+static const unsigned int bitsPerWord = 8 * sizeof(unsigned long);
+
+/*Label identifier of states without a reward specification.*/
+static const unsigned int noLabel = ~0U;
+
+/*Initial number of slots of a hash table.*/
+static const unsigned int initialSlots = 16;
+
+/*Avalanche the bits of the argument (the MurmurHash3 finaliser).*/
+static inline StateHash mix(StateHash h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/*Fold the argument value into the hash \argument{h}.*/
+static inline StateHash combine(StateHash h, StateHash value)
+{
+    return mix(h ^ (value + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2)));
+}
+
+/*******************************************************StringInterner*/
+
+StringInterner::StringInterner()
+    :table(initialSlots, 0)
+{}
+
+unsigned int StringInterner::intern(const string& str)
+{
+    StateHash h = hash(str);
+    unsigned int mask = table.size() - 1;
+    unsigned int i = h & mask;
+
+    for(; 0 != table[i]; i = (i + 1) & mask)
+    {
+        unsigned int id = table[i] - 1;
+        if(hashes[id] == h && strings[id] == str)
+            return id;
+    }
+
+    /*Keep the table at most half full.*/
+    if(2 * (strings.size() + 1) > table.size())
+    {
+        grow();
+        mask = table.size() - 1;
+        for(i = h & mask; 0 != table[i]; i = (i + 1) & mask);
+    }
+
+    strings.push_back(str);
+    hashes.push_back(h);
+    table[i] = strings.size();
+
+    return strings.size() - 1;
+}
+
+unsigned int StringInterner::find(const string& str)const
+{
+    StateHash h = hash(str);
+    unsigned int mask = table.size() - 1;
+
+    for(unsigned int i = h & mask; 0 != table[i]; i = (i + 1) & mask)
+    {
+        unsigned int id = table[i] - 1;
+        if(hashes[id] == h && strings[id] == str)
+            return id;
+    }
+
+    return strings.size();
+}
+
+const string& StringInterner::operator[](unsigned int id)const
+{
+    return strings[id];
+}
+
+unsigned int StringInterner::size()const
+{
+    return strings.size();
+}
+
+void StringInterner::clear()
+{
+    strings.clear();
+    hashes.clear();
+    table.assign(initialSlots, 0);
+}
+
+unsigned int StringInterner::memory()const
+{
+    unsigned int size = sizeof(*this);
+
+    for(vector<string>::const_iterator p = strings.begin()
+            ; p != strings.end()
+            ; ++p)
+        size += sizeof(*p) + sizeof(char) * p->size();
+
+    size += sizeof(StateHash) * hashes.capacity();
+    size += sizeof(unsigned int) * table.capacity();
+
+    return size;
+}
+
+StateHash StringInterner::hash(const string& str)
+{
+    StateHash h = 0xcbf29ce484222325ULL;
+
+    for(string::const_iterator c = str.begin(); c != str.end(); ++c)
+    {
+        h ^= static_cast<unsigned char>(*c);
+        h *= 0x100000001b3ULL;
+    }
+
+    return h;
+}
+
+void StringInterner::grow()
+{
+    table.assign(2 * table.size(), 0);
+    unsigned int mask = table.size() - 1;
+
+    for(unsigned int id = 0; id < strings.size(); ++id)
+    {
+        unsigned int i;
+        for(i = hashes[id] & mask; 0 != table[i]; i = (i + 1) & mask);
+        table[i] = id + 1;
+    }
+}
+
+/*******************************************************StateStore*/
+
+        /*
+         *Construction
+         */
+
+StateStore::StateStore(Formula::FormulaTable* formulaTable,
+                       const vector<proposition>& domainPropositions)
+    :formulaTable(formulaTable),
+     words(0),
+     occupied(0),
+     used(0)
+{
+    for(vector<proposition>::const_iterator p = domainPropositions.begin()
+            ; p != domainPropositions.end()
+            ; ++p)
+        propositionIds.intern(*p);
+
+    unsigned int domainWords
+        = (propositionIds.size() + bitsPerWord - 1) / bitsPerWord;
+
+    rebuild(initialSlots, (0 == domainWords) ? 1 : domainWords);
+}
+
+StateStore::~StateStore()
+{}
+
+        /*
+         *Functionality
+         */
+
+eState* StateStore::find(const eState& state)const
+{
+    ScopedTimer timer(Instrumentation::stateStoreLookup);
+
+    Slot stateKey;
+    vector<unsigned long> stateBits;
+
+    if(!findKey(state, stateKey, stateBits))
+        return 0;
+
+    return slots[probe(stateKey, stateBits)].state;
+}
+
+void StateStore::insert(eState* state)
+{
+    findOrInsert(state);
+}
+
+eState* StateStore::findOrInsert(eState* state)
+{
+    ScopedTimer timer(Instrumentation::stateStoreLookup);
+
+    makeKey(*state);
+
+    /*Keep the table at most three quarters used, rebuilding to at
+      most half occupied.*/
+    if(4 * (used + 1) > 3 * slots.size())
+    {
+        unsigned int size = slots.size();
+        while(2 * (occupied + 1) > size)
+            size *= 2;
+        rebuild(size, words);
+    }
+
+    unsigned int i = probe(key, keyBits);
+
+    if(0 != slots[i].state)
+        return slots[i].state;
+
+    if(!slots[i].erased)
+        ++used;
+    ++occupied;
+
+    slots[i] = key;
+    slots[i].state = state;
+    copy(keyBits.begin(), keyBits.end(), bits.begin() + i * words);
+
+    Instrumentation::count(Instrumentation::stateStoreInsertion);
+
+    return 0;
+}
+
+void StateStore::erase(eState* state)
+{
+    Slot stateKey;
+    vector<unsigned long> stateBits;
+    unsigned int mask = slots.size() - 1;
+    unsigned int i = slots.size();
+
+    /*Search the probe sequence of the state.*/
+    if(findKey(*state, stateKey, stateBits))
+        for(i = stateKey.hash & mask
+                ; slots[i].state != state && (0 != slots[i].state || slots[i].erased)
+                ; i = (i + 1) & mask);
+
+    /*A state changed since its insertion is not on its probe
+      sequence, it is searched for in every slot.*/
+    if(slots.size() == i || slots[i].state != state)
+        for(i = 0; i < slots.size() && slots[i].state != state; ++i);
+
+    if(slots.size() == i)
+        return;
+
+    slots[i].state = 0;
+    slots[i].erased = true;
+    --occupied;
+}
+
+void StateStore::clear()
+{
+    slots.clear();
+    occupied = 0;
+    rebuild(initialSlots, words);
+
+    labelIds.clear();
+}
+
+        /*
+         *Queries + Accessors
+         */
+
+unsigned int StateStore::size()const
+{
+    return occupied;
+}
+
+unsigned int StateStore::numberOfLabels()const
+{
+    return labelIds.size();
+}
+
+unsigned int StateStore::memory()const
+{
+    unsigned int size = sizeof(*this);
+
+    size += sizeof(Slot) * slots.capacity();
+    size += sizeof(unsigned long) * (bits.capacity() + keyBits.capacity());
+    size += propositionIds.memory() - sizeof(propositionIds);
+    size += labelNames.memory() - sizeof(labelNames);
+    size += labelIds.memory() - sizeof(labelIds);
+    size += sizeof(char) * labelKey.capacity();
+
+    return size;
+}
+
+        /*
+         *Private
+         */
+
+/*Append the bytes of the argument \argument{value} to the string
+  \argument{str}.*/
+template<typename T>
+static inline void appendBytes(string& str, const T& value)
+{
+    str.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/*Append an element of a reward specification to the argument
+  \argument{labelKey}, given the identifier of its name.*/
+static inline void appendElement(string& labelKey,
+                                 unsigned int name,
+                                 double value,
+                                 unsigned int form)
+{
+    /*Equal values must have equal bits.*/
+    if(0.0 == value)
+        value = 0.0;
+
+    appendBytes(labelKey, name);
+    appendBytes(labelKey, value);
+    appendBytes(labelKey, form);
+}
+
+void StateStore::initialiseKey(const eState& state, Slot& key)
+{
+    key.state = 0;
+    key.erased = false;
+
+    /*Equal rewards must have equal bits, thus $-0.0$ is made $0.0$.*/
+    key.reward = state.getReward();
+    if(0.0 == key.reward)
+        key.reward = 0.0;
+
+    key.possible = state.isPossible();
+}
+
+StateHash StateStore::hashKey(const Slot& key,
+                             StateHash labelHash,
+                             const vector<unsigned long>& keyBits)
+{
+    StateHash rewardBits = 0;
+    memcpy(&rewardBits, &key.reward, sizeof(key.reward));
+
+    /*Zero words are skipped so that hashes do not depend on
+      \member{words}.*/
+    StateHash h = combine(mix(rewardBits), key.possible);
+    h = combine(h, labelHash);
+    for(unsigned int w = 0; w < keyBits.size(); ++w)
+        if(0 != keyBits[w])
+            h = combine(h, mix(w) ^ keyBits[w]);
+
+    return h;
+}
+
+void StateStore::makeKey(const eState& state)
+{
+    initialiseKey(state, key);
+
+    /*Labels are renumbered before they outnumber the stored states
+      by more than the initial table size.*/
+    if(labelIds.size() > 2 * occupied + initialSlots)
+        compactLabels();
+
+    /*The hash of a label is that of its key, not its identifier,
+      which changes when the labels are compacted.*/
+    StateHash labelHash = noLabel;
+    RewardSpecification const* rewardSpecification
+        = state.getRewardSpecification();
+    if(0 == rewardSpecification)
+        key.label = noLabel;
+    else
+    {
+        labelKey.clear();
+        for(RewardSpecification::crIterator p = rewardSpecification->begin()
+                ; p != rewardSpecification->end()
+                ; ++p)
+            appendElement(labelKey,
+                          labelNames.intern(p->first),
+                          p->second.value,
+                          formulaTable->intern(p->second.form)->getNodeId());
+
+        key.label = labelIds.intern(labelKey);
+        labelHash = StringInterner::hash(labelKey);
+    }
+
+    keyBits.assign(words, 0);
+    for(DomainSpecification::PropositionSet::const_iterator p
+            = state.getPropositions().begin()
+            ; p != state.getPropositions().end()
+            ; ++p)
+    {
+        unsigned int id = propositionIds.intern(*p);
+        if(id / bitsPerWord >= keyBits.size())
+            keyBits.resize(id / bitsPerWord + 1, 0);
+        keyBits[id / bitsPerWord] |= 1UL << (id % bitsPerWord);
+    }
+
+    /*A proposition outside the domain widens every entry.*/
+    if(keyBits.size() > words)
+        rebuild(slots.size(), keyBits.size());
+
+    key.hash = hashKey(key, labelHash, keyBits);
+}
+
+bool StateStore::findKey(const eState& state,
+                         Slot& stateKey,
+                         vector<unsigned long>& stateBits)const
+{
+    initialiseKey(state, stateKey);
+
+    StateHash labelHash = noLabel;
+    RewardSpecification const* rewardSpecification
+        = state.getRewardSpecification();
+    if(0 == rewardSpecification)
+        stateKey.label = noLabel;
+    else
+    {
+        string stateLabelKey;
+        for(RewardSpecification::crIterator p = rewardSpecification->begin()
+                ; p != rewardSpecification->end()
+                ; ++p)
+        {
+            unsigned int name = labelNames.find(p->first);
+            if(labelNames.size() == name)
+                return false;
+
+            appendElement(stateLabelKey,
+                          name,
+                          p->second.value,
+                          formulaTable->intern(p->second.form)->getNodeId());
+        }
+
+        stateKey.label = labelIds.find(stateLabelKey);
+        if(labelIds.size() == stateKey.label)
+            return false;
+        labelHash = StringInterner::hash(stateLabelKey);
+    }
+
+    stateBits.assign(words, 0);
+    for(DomainSpecification::PropositionSet::const_iterator p
+            = state.getPropositions().begin()
+            ; p != state.getPropositions().end()
+            ; ++p)
+    {
+        /*Every interned proposition has a bit in each entry.*/
+        unsigned int id = propositionIds.find(*p);
+        if(propositionIds.size() == id)
+            return false;
+        stateBits[id / bitsPerWord] |= 1UL << (id % bitsPerWord);
+    }
+
+    stateKey.hash = hashKey(stateKey, labelHash, stateBits);
+
+    return true;
+}
+
+void StateStore::compactLabels()
+{
+    StringInterner live;
+    vector<unsigned int> ids(labelIds.size(), noLabel);
+
+    for(vector<Slot>::iterator slot = slots.begin(); slot != slots.end(); ++slot)
+    {
+        if(0 == slot->state || noLabel == slot->label)
+            continue;
+
+        if(noLabel == ids[slot->label])
+            ids[slot->label] = live.intern(labelIds[slot->label]);
+
+        slot->label = ids[slot->label];
+    }
+
+    labelIds = live;
+}
+
+unsigned int StateStore::probe(const Slot& key,
+                               const vector<unsigned long>& keyBits)const
+{
+    unsigned int mask = slots.size() - 1;
+    unsigned int firstErased = slots.size();
+
+    for(unsigned int i = key.hash & mask; ; i = (i + 1) & mask)
+    {
+        const Slot& slot = slots[i];
+
+        if(0 == slot.state)
+        {
+            if(!slot.erased)
+                return (firstErased != slots.size()) ? firstErased : i;
+
+            if(firstErased == slots.size())
+                firstErased = i;
+        }
+        else if(slot.hash == key.hash
+                && slot.reward == key.reward
+                && slot.possible == key.possible
+                && slot.label == key.label
+                && equal(keyBits.begin(), keyBits.end(), bits.begin() + i * words))
+            return i;
+    }
+}
+
+void StateStore::rebuild(unsigned int size, unsigned int newWords)
+{
+    vector<Slot> oldSlots(size);
+    vector<unsigned long> oldBits(size * newWords, 0);
+    unsigned int oldWords = words;
+
+    oldSlots.swap(slots);
+    oldBits.swap(bits);
+    words = newWords;
+
+    Slot free = {0, 0, 0.0, 0, false, false};
+    fill(slots.begin(), slots.end(), free);
+
+    unsigned int mask = size - 1;
+    for(unsigned int j = 0; j < oldSlots.size(); ++j)
+    {
+        if(0 == oldSlots[j].state)
+            continue;
+
+        unsigned int i;
+        for(i = oldSlots[j].hash & mask; 0 != slots[i].state; i = (i + 1) & mask);
+
+        slots[i] = oldSlots[j];
+        copy(oldBits.begin() + j * oldWords,
+             oldBits.begin() + j * oldWords + min(oldWords, newWords),
+             bits.begin() + i * newWords);
+    }
+
+    used = occupied;
+}
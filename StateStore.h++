@@ -0,0 +1,241 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+/*
+ * \paragraph{:Purpose:}
+ *
+ * Hashed storage of the \class{eState}s of an explicit domain
+ * specification. State identity is that of
+ * \method{eState::operator==()}, however the store does not keep
+ * copies of the states it indexes. Instead each state is reduced to
+ * a key comprised of its reward, its possibility, an interned bit
+ * vector of its propositions and an interned identifier of its
+ * reward specification. Keys are indexed by a $64$ bit structural
+ * hash in an open addressing table.
+ *
+ * A reward specification is identified by the names, values and
+ * canonical formulae (see \class{FormulaTable}) of its elements, so
+ * no formula is printed to find a state. Canonical formulae are equal
+ * modulo the order of commutative operands, thus two states whose
+ * labels differ only in that order are the same state to the store.
+ **/
+#ifndef STATE_STORE
+#define STATE_STORE
+
+#include"SpecificationTypes.h++"
+#include"formulaHashConsing.h++"
+
+using namespace std;
+
+namespace MDP
+{
+    /*Structural hash of a \class{eState}.*/
+    typedef unsigned long long StateHash;
+
+    /*Maps strings to dense integer identifiers. Identifiers are
+     *allocated in order of first occurrence starting from $0$.*/
+    class StringInterner
+    {
+    public:
+        /*Construction of an empty interner.*/
+        StringInterner();
+
+        /*Identifier of the argument \argument{string}. If the string
+         *has not been interned it is interned.*/
+        unsigned int intern(const string&);
+
+        /*Identifier of the argument \argument{string} if it has been
+         *interned, \member{size()} otherwise.*/
+        unsigned int find(const string&)const;
+
+        /*String associated with the argument identifier.*/
+        const string& operator[](unsigned int)const;
+
+        /*Number of interned strings.*/
+        unsigned int size()const;
+
+        /*Forget all the interned strings.*/
+        void clear();
+
+        /*Approximately the amount of memory taken by this
+         *interner. The result is a number of bytes.*/
+        unsigned int memory()const;
+
+        /*$64$ bit FNV--1a hash of the argument string.*/
+        static StateHash hash(const string&);
+    private:
+        /*Interned strings indexed by identifier.*/
+        vector<string> strings;
+
+        /*Hashes of the \member{strings} indexed by identifier.*/
+        vector<StateHash> hashes;
+
+        /*Open addressing table of identifiers plus one, $0$ is an
+         *empty slot. The size is always a power of two.*/
+        vector<unsigned int> table;
+
+        /*Double the size of the \member{table}.*/
+        void grow();
+    };
+
+    /*Hashed store of \class{eState} pointers (see file comment).*/
+    class StateStore
+    {
+    public:
+        /*Construction of an empty store. Reward labels are interned
+         *by the argument \argument{FormulaTable}, which must outlive
+         *the store. The \argument{PropositionVector} seeds the
+         *proposition interner so that the bit vectors of the domain
+         *states are of a fixed width. Propositions outside this set
+         *are still accepted.*/
+        StateStore(Formula::FormulaTable*,
+                   const vector<proposition>& = vector<proposition>());
+
+        /*The store does not own the states it indexes.*/
+        ~StateStore();
+
+        /*Find a stored state equal to the argument (see
+         *\method{eState::operator==()}). Returns $0$ if there is no
+         *such state. Nothing is interned, thus finding does not
+         *change the store.*/
+        eState* find(const eState&)const;
+
+        /*Add the argument state to the store. The caller must ensure
+         *no equal state is already stored.*/
+        void insert(eState*);
+
+        /*Find an equal state. If there is none the argument is
+         *inserted and $0$ returned, otherwise the stored state is
+         *returned and the store is unchanged.*/
+        eState* findOrInsert(eState*);
+
+        /*Remove the argument state from the store. A caller that
+         *changes a stored state erases it first and inserts it
+         *again afterwards. A state that has changed since its
+         *insertion is still erased, but only after a search of the
+         *whole table.*/
+        void erase(eState*);
+
+        /*Remove all the states from the store. Interned propositions
+         *are kept, reward labels are forgotten.*/
+        void clear();
+
+        /*Number of stored states.*/
+        unsigned int size()const;
+
+        /*Number of interned reward labels. Labels of states that
+         *are no longer stored are dropped once they outnumber the
+         *stored states (see \method{compactLabels()}).*/
+        unsigned int numberOfLabels()const;
+
+        /*Approximately the amount of memory taken by this store. The
+         *result is a number of bytes.*/
+        unsigned int memory()const;
+    private:
+        /*An entry in the open addressing table. The proposition bits
+         *of the entry in slot $i$ are stored at $i \times$
+         *\member{words} in \member{bits}.*/
+        struct Slot
+        {
+            StateHash hash;
+            eState* state;
+            double reward;
+            unsigned int label;
+            bool possible;
+
+            /*Has the state in this slot been erased?*/
+            bool erased;
+        };
+
+        /*Interned propositions, the identifier is the bit index.*/
+        StringInterner propositionIds;
+
+        /*Table of the canonical formulae of the reward labels.*/
+        Formula::FormulaTable* formulaTable;
+
+        /*Interned names of the elements of reward specifications.*/
+        StringInterner labelNames;
+
+        /*Interned reward specification keys. A key is the sequence
+         *of name identifiers, values and canonical formula
+         *identifiers (see \method{formula::getNodeId()}) of the
+         *specification elements, packed as bytes.*/
+        StringInterner labelIds;
+
+        /*Scratch reward specification key of
+         *\method{findOrInsert()}.*/
+        string labelKey;
+
+        /*The open addressing table. The size is always a power of
+         *two. Free slots have a $0$ \member{Slot::state}.*/
+        vector<Slot> slots;
+
+        /*Proposition bits of the \member{slots}.*/
+        vector<unsigned long> bits;
+
+        /*Number of words of proposition bits per slot.*/
+        unsigned int words;
+
+        /*Number of occupied slots.*/
+        unsigned int occupied;
+
+        /*Number of slots that are occupied or have been erased since
+         *the last rebuild.*/
+        unsigned int used;
+
+        /*Scratch key of \method{findOrInsert()}.*/
+        Slot key;
+
+        /*Scratch proposition bits of \method{findOrInsert()}.*/
+        vector<unsigned long> keyBits;
+
+        /*Compute \member{key} and \member{keyBits} from the
+         *argument, interning its propositions and label.*/
+        void makeKey(const eState&);
+
+        /*Compute the argument key and proposition bits of the
+         *argument state, interning nothing. Returns false if the
+         *state has a proposition or label that has not been
+         *interned, thus no equal state is stored.*/
+        bool findKey(const eState&, Slot&, vector<unsigned long>&)const;
+
+        /*Set the reward and possibility of the argument key to those
+         *of the state.*/
+        static void initialiseKey(const eState&, Slot&);
+
+        /*Hash of the argument key, given the hash of its label key
+         *and its proposition bits.*/
+        static StateHash hashKey(const Slot&,
+                                 StateHash labelHash,
+                                 const vector<unsigned long>&);
+
+        /*Drop the \member{labelIds} of labels no stored state has,
+         *renumbering the labels of the \member{slots}.*/
+        void compactLabels();
+
+        /*Slot of the stored state equal to the argument key and
+         *proposition bits, or of the first free or erased slot along
+         *the probe sequence if there is none.*/
+        unsigned int probe(const Slot&, const vector<unsigned long>&)const;
+
+        /*Rebuild the table with the argument number of slots and
+         *bit words per slot, dropping erased slots.*/
+        void rebuild(unsigned int size, unsigned int words);
+    };
+}
+
+#endif
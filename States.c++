@@ -235,15 +235,11 @@ void  State::setReward(double reward)
     this->reward = value = reward;
 }
 
-unsigned int State::memory()const
+unsigned long long State::memory()const
 {
-    unsigned int size = sizeof(*this);
+    unsigned long long size = sizeof(*this);
 
-    for(DomainSpecification::PropositionSet::const_iterator p
-            = propositions.begin()
-            ; p != propositions.end()
-            ; ++p)
-        size += sizeof(char) * p->size();
+    size += State::heapMemory();
 
     size += sizeof(reward);
     size += sizeof(value);
@@ -253,6 +249,7 @@ unsigned int State::memory()const
             ; p != stms.end()
             ; ++p )
         {
+            size += DomainSpecification::treeNodeOverhead + sizeof(*p);
             size += sizeof(char) * p->first.size();
                        for(ActionPossibilities::const_iterator q = p->second.begin()
                                ; q != p->second.end()
@@ -267,6 +264,21 @@ unsigned int State::memory()const
     return size;
 }
 
+unsigned long long State::heapMemory()const
+{
+    unsigned long long size = 0;
+
+    for(DomainSpecification::PropositionSet::const_iterator p
+            = propositions.begin()
+            ; p != propositions.end()
+            ; ++p)
+        size += DomainSpecification::treeNodeOverhead
+            + sizeof(*p)
+            + sizeof(char) * p->size();
+
+    return size;
+}
+
 void State::setColour(int colour)
 {
     colouring = colour;
@@ -454,15 +466,20 @@ string eState::toString(bool identify)const
     return answer;
 }
 
-unsigned int eState::memory()const
+unsigned long long eState::memory()const
 {
-    unsigned int size = State::memory() + sizeof(*this) - sizeof(State);
+    unsigned long long size = State::memory() + sizeof(*this) - sizeof(State);
 
-    size += rewardSpecification->size();
+    size += sizeof(*rewardSpecification) + rewardSpecification->heapMemory();
     
     return size;
 }
 
+unsigned long long eState::heapMemory()const
+{
+    return State::heapMemory() + rewardSpecification->heapMemory();
+}
+
 
 /******************************************basedExpandedState Implementation*/
 
@@ -574,11 +591,16 @@ void basedExpandedState::setLabelSet(const RewardSpecification& newLabelSet)
     labelSet = newLabelSet.copy();
 }
 
-unsigned int basedExpandedState::memory()const
+unsigned long long basedExpandedState::memory()const
 {
-    unsigned int size = eState::memory() + sizeof(*this) - sizeof(eState);
+    unsigned long long size = eState::memory() + sizeof(*this) - sizeof(eState);
 
-    size += labelSet->size();
+    size += sizeof(*labelSet) + labelSet->heapMemory();
     
     return size;
 }
+
+unsigned long long basedExpandedState::heapMemory()const
+{
+    return eState::heapMemory() + labelSet->heapMemory();
+}
@@ -85,6 +85,12 @@ namespace MDP
     class State
     {
     public:
+        /*States are allocated from the current \class{Arena}, which
+         *is that of the \class{explicitDomainSpecification} they
+         *belong to.*/
+        static void* operator new(size_t size){return Arena::allocate(size);}
+        static void operator delete(void* state){Arena::deallocate(state);}
+
         /*States are characterised by the argument set of propositions
          *which hold when a domain is in them. States are assumed to
          *be possible. A states \member{colouring} is initially $0$.*/
@@ -177,8 +183,15 @@ namespace MDP
         double getValue() const;
 
         /*Approximately the amount of memory taken by this
-         *\class{State}. The result is a number of Kb.*/
-        virtual unsigned int memory()const;
+         *\class{State}, including its \method{heapMemory()}. The
+         *result is a number of bytes.*/
+        virtual unsigned long long memory()const;
+
+        /*Approximately the number of bytes of the parts of this
+         *\class{State} that are kept on the heap whichever
+         *\class{Arena} is current: the nodes of its
+         *\member{propositions} and their names.*/
+        virtual unsigned long long heapMemory()const;
         
         /*Transition traversal.*/
         
@@ -321,8 +334,12 @@ namespace MDP
         RewardSpecification const* getRewardSpecification() const;
 
         /*Approximately the amount of memory taken by this
-         *\class{State}. The result is a number of Kb.*/
-        unsigned int memory()const;
+         *\class{eState}. The result is a number of bytes.*/
+        unsigned long long memory()const;
+
+        /*Adds the heap taken by the \member{rewardSpecification}
+         *(see \method{RewardSpecification::heapMemory()}).*/
+        unsigned long long heapMemory()const;
     protected:
         /*Reward formulae which this e-state is annotated with.*/
         RewardSpecification* rewardSpecification;
@@ -413,8 +430,12 @@ namespace MDP
         void updatePredecessorReward(basedExpandedState&) const;
 
         /*Approximately the amount of memory taken by this
-         *\class{basedExpandedState}. The result is a number of Kb.*/
-        unsigned int memory()const;
+         *\class{basedExpandedState}. The result is a number of
+         *bytes.*/
+        unsigned long long memory()const;
+
+        /*Adds the heap taken by the \member{labelSet}.*/
+        unsigned long long heapMemory()const;
     protected:
         /*Reward formulae which comprises this states labelled set.*/
         RewardSpecification* labelSet;
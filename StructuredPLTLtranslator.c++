@@ -90,7 +90,7 @@ PUBLIC bool StructuredPLTLtranslator::operator()()
     
     formula *form = nextReward->second.form;
     form->accept(this);
-    delete form;
+    RewardSpecification::releaseFormula(form);
     nextReward->second.form = rhsFormula;
 
     nextReward++;
@@ -15,11 +15,103 @@
 // License along with this library; if not, write to the Free Software
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
+#include<algorithm>
+
 #include "ValueIteration.h++"
 #include"domainSpecification_Anytime_or_Explicit.h++"
+#include"WorkerPool.h++"
+#include"Instrumentation.h++"
 
 using namespace mtl;
 
+/*Fewest states compared by a thread of the \class{WorkerPool} in
+ *\method{ValueIteration::terminate()}.*/
+static const unsigned int normGrain = 1024;
+
+/*Fewest states backed up by a thread of the \class{WorkerPool} in
+ *\method{ValueIteration::operator()()}.*/
+static const unsigned int backupGrain = 1024;
+
+/*Backup of a block of states (see
+ *\method{ValueIteration::operator()()}). Each block computes the rows
+ *of its states of the discounted product of every action matrix with
+ *the last epoch values, and writes only the values and choices of its
+ *states. The rows are computed as by \function{mult()}, thus the
+ *result does not depend on the number of threads.*/
+class EpochBackups : public ParallelTask
+{
+public:
+    EpochBackups(const ActionMatrices& actionMatrices,
+                 const ValueVector& lastEpoch,
+                 double gamma,
+                 ValueVector& thisEpoch,
+                 vector<action const*>& choices)
+        :actionMatrices(actionMatrices),
+         lastEpoch(lastEpoch),
+         gamma(gamma),
+         thisEpoch(thisEpoch),
+         choices(choices){}
+
+    void operator()(unsigned int begin, unsigned int end, unsigned int)
+    {
+        /*For each action, in order.*/
+        for(ActionMatrices::const_iterator action = actionMatrices.begin()
+                ; action != actionMatrices.end()
+                ; ++action)
+        {
+            const ActionMatrix& matrix = action->second;
+
+            /*Was this action superior for any state?*/
+            for(unsigned int j = begin; j != end; ++j)
+            {
+                double value = 0.0;
+                for(ActionMatrix::OneD::const_iterator transition = matrix[j].begin()
+                        ; transition != matrix[j].end()
+                        ; ++transition)
+                    value += *transition * lastEpoch[transition.column()];
+                value *= gamma;
+
+                if(value > thisEpoch[j])
+                {
+                    thisEpoch[j] = value;
+                    choices[j] = &action->first;
+                }
+            }
+        }
+    }
+private:
+    const ActionMatrices& actionMatrices;
+    const ValueVector& lastEpoch;
+    double gamma;
+    ValueVector& thisEpoch;
+    vector<action const*>& choices;
+};
+
+/*Greatest difference of two value vectors, one partial result per
+ *block (see \method{ValueIteration::terminate()}).*/
+class GreatestDifference : public ParallelTask
+{
+public:
+    GreatestDifference(const ValueVector& thisEpoch,
+                       const ValueVector& lastEpoch,
+                       vector<double>& differences)
+        :thisEpoch(thisEpoch),
+         lastEpoch(lastEpoch),
+         differences(differences){}
+
+    void operator()(unsigned int begin, unsigned int end, unsigned int block)
+    {
+        double difference = thisEpoch[begin] + (-1.0 * lastEpoch[begin]);
+        for(unsigned int i = begin + 1; i < end; ++i)
+            difference = max(difference, thisEpoch[i] + (-1.0 * lastEpoch[i]));
+        differences[block] = difference;
+    }
+private:
+    const ValueVector& thisEpoch;
+    const ValueVector& lastEpoch;
+    vector<double>& differences;
+};
+
 ValueIteration::ValueIteration(DomainSpecification* domSpec)
     : Algorithm(*domSpec),
       epoch(0),
@@ -178,45 +270,44 @@ void ValueIteration::updateStateValues()
 
 bool ValueIteration::terminate(const ValueVector thisEpoch, const ValueVector lastEpoch)
 {   
-    ValueVector negatedLastEpoch(lastEpoch.size());
-    ValueVector norm(lastEpoch.size());
-    
-    copy(scaled(lastEpoch, -1.0), negatedLastEpoch);
-    add(thisEpoch, negatedLastEpoch, norm);
-    int normIndex = max_index(norm);
+    WorkerPool* pool = WorkerPool::getInstance();
+
+    /*Every block writes only its own difference.*/
+    vector<double> differences(pool->blocks(lastEpoch.size(), normGrain), 0.0);
+
+    if(0 != lastEpoch.size())
+    {
+        GreatestDifference task(thisEpoch, lastEpoch, differences);
+        pool->run(task, lastEpoch.size(), normGrain);
+    }
 
-    Algorithm::error = norm[normIndex];
+    double norm = *max_element(differences.begin(), differences.end());
+
+    Algorithm::error = norm;
     
-    return (norm[normIndex] <= (epsilon * ((1 - gamma)/(2*gamma))));
+    return (norm <= (epsilon * ((1 - gamma)/(2*gamma))));
 }
 
 bool ValueIteration::operator()()
 {
     epoch++;
 
+    /*An epoch backs up every state.*/
+    ScopedTimer timer(Instrumentation::bellmanBackup, domainStates.size());
+
     thisEpoch = ValueVector(domainStates.size());
-    
-    /*For each action.*/
-    for(ActionMatrices::const_iterator action = actionMatrices.begin()
-            ; action != actionMatrices.end()
-            ; ++action)
-    {
-        ValueVector tmp(domainStates.size());
-        
-        mult(action->second, lastEpoch, tmp);
-        
-        copy(scaled(tmp, gamma), tmp);
-        
-        /*Was this action superior for any state?*/
-        for(unsigned int j = 0;  j < domainStates.size(); ++j)
-        {
-            if(tmp[j] > thisEpoch[j])
-            {
-                thisEpoch[j] = tmp[j];
-                (*policy)[domainStates[j]] = action->first;
-            }
-        }    
-    }
+
+    /*The action chosen at each state by this epoch, $0$ where no
+      action has a positive value. The policy is written after the
+      backups, as it is not safe to write concurrently.*/
+    vector<action const*> choices(domainStates.size(), 0);
+
+    EpochBackups task(actionMatrices, lastEpoch, gamma, thisEpoch, choices);
+    WorkerPool::getInstance()->run(task, domainStates.size(), backupGrain);
+
+    for(unsigned int j = 0;  j < domainStates.size(); ++j)
+        if(0 != choices[j])
+            (*policy)[domainStates[j]] = *choices[j];
 
     add(thisEpoch, initialReward, thisEpoch);
  
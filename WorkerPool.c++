@@ -0,0 +1,214 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include"WorkerPool.h++"
+
+#include<cassert>
+#include<iostream>
+
+using namespace std;
+
+/*Items from \argument{begin} to \argument{end} of block
+ *\argument{block} when \argument{size} items are divided into
+ *\argument{blocks} blocks.*/
+static void blockRange(unsigned int size, unsigned int blocks, unsigned int block,
+                       unsigned int& begin, unsigned int& end)
+{
+    unsigned int quotient = size / blocks;
+    unsigned int remainder = size % blocks;
+
+    /*The first $remainder$ blocks have one more item.*/
+    begin = block * quotient + ((block < remainder) ? block : remainder);
+    end = begin + quotient + ((block < remainder) ? 1 : 0);
+}
+
+WorkerPool* WorkerPool::instance = 0;
+
+WorkerPool* WorkerPool::getInstance()
+{
+    if(0 == instance)
+        instance = new WorkerPool();
+    return instance;
+}
+
+void WorkerPool::destroyInstance()
+{
+    delete instance;
+    instance = 0;
+}
+
+WorkerPool::WorkerPool()
+    :task(0),
+     size(0),
+     taskBlocks(0),
+     generation(0),
+     pending(0),
+     stopping(false)
+{
+    pthread_mutex_init(&mutex, 0);
+    pthread_cond_init(&posted, 0);
+    pthread_cond_init(&completed, 0);
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+
+    pthread_cond_destroy(&completed);
+    pthread_cond_destroy(&posted);
+    pthread_mutex_destroy(&mutex);
+}
+
+void WorkerPool::setThreads(unsigned int threads)
+{
+    if(0 == threads)
+        threads = 1;
+
+    if(threads == getThreads())
+        return;
+
+    stop();
+
+    for(unsigned int block = 1; block < threads; ++block)
+    {
+        Worker* worker = new Worker;
+        worker->pool = this;
+        worker->block = block;
+        worker->seen = generation;
+
+        if(pthread_create(&worker->thread, 0, &WorkerPool::work, worker))
+        {
+            cerr<<"Thread could not be created\n";
+            delete worker;
+            break;
+        }
+
+        workers.push_back(worker);
+    }
+}
+
+unsigned int WorkerPool::getThreads()const
+{
+    return workers.size() + 1;
+}
+
+unsigned int WorkerPool::blocks(unsigned int size, unsigned int grain)const
+{
+    if(0 == grain)
+        grain = 1;
+
+    unsigned int result = size / grain;
+
+    if(result > getThreads())
+        result = getThreads();
+
+    return (0 == result) ? 1 : result;
+}
+
+void WorkerPool::run(ParallelTask& task, unsigned int size, unsigned int grain)
+{
+    unsigned int taskBlocks = blocks(size, grain);
+
+    /*Small tasks are not worth the synchronisation.*/
+    if(1 == taskBlocks)
+    {
+        task(0, size, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&mutex);
+    this->task = &task;
+    this->size = size;
+    this->taskBlocks = taskBlocks;
+    pending = workers.size();
+    ++generation;
+    pthread_cond_broadcast(&posted);
+    pthread_mutex_unlock(&mutex);
+
+    unsigned int begin, end;
+    blockRange(size, taskBlocks, 0, begin, end);
+    task(begin, end, 0);
+
+    pthread_mutex_lock(&mutex);
+    while(0 != pending)
+        pthread_cond_wait(&completed, &mutex);
+    this->task = 0;
+    pthread_mutex_unlock(&mutex);
+}
+
+void* WorkerPool::work(void* argument)
+{
+    Worker* worker = static_cast<Worker*>(argument);
+    WorkerPool* pool = worker->pool;
+
+    pthread_mutex_lock(&pool->mutex);
+
+    while(true)
+    {
+        while(!pool->stopping && worker->seen == pool->generation)
+            pthread_cond_wait(&pool->posted, &pool->mutex);
+
+        if(pool->stopping)
+            break;
+
+        worker->seen = pool->generation;
+
+        ParallelTask* task = pool->task;
+        unsigned int size = pool->size;
+        unsigned int taskBlocks = pool->taskBlocks;
+
+        pthread_mutex_unlock(&pool->mutex);
+
+        /*A task may have fewer blocks than there are threads.*/
+        if(worker->block < taskBlocks)
+        {
+            unsigned int begin, end;
+            blockRange(size, taskBlocks, worker->block, begin, end);
+            (*task)(begin, end, worker->block);
+        }
+
+        pthread_mutex_lock(&pool->mutex);
+        if(0 == --pool->pending)
+            pthread_cond_signal(&pool->completed);
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    return 0;
+}
+
+void WorkerPool::stop()
+{
+    pthread_mutex_lock(&mutex);
+    stopping = true;
+    pthread_cond_broadcast(&posted);
+    pthread_mutex_unlock(&mutex);
+
+    for(vector<Worker*>::iterator worker = workers.begin()
+            ; worker != workers.end()
+            ; ++worker)
+    {
+        if(pthread_join((*worker)->thread, 0))
+        {
+            cerr<<"Thread could not be destroyed\n";assert(0);
+        }
+        delete *worker;
+    }
+
+    workers.clear();
+    stopping = false;
+}
@@ -0,0 +1,146 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+/*
+ * \paragraph{:Purpose:}
+ *
+ * Where the threads of \module{Thread} report on algorithms, the
+ * threads of this module take part in them. A \class{WorkerPool}
+ * keeps a number of pthreads waiting for a \class{ParallelTask}. A
+ * task over $n$ items is divided into one contiguous block of items
+ * per thread. The division depends only on $n$ and the number of
+ * threads, so that a task which combines the results of the blocks
+ * in block order computes the same result however the threads are
+ * scheduled.
+ *
+ * The number of threads is set by the \textbf{threads} command of the
+ * \class{CommandInterpreter}. With one thread, the default, all tasks
+ * are executed by the calling thread.
+ * */
+
+#ifndef WORKER_POOL
+#define WORKER_POOL
+
+#include<vector>
+#include<pthread.h>
+
+using namespace std;
+
+/*Work that can be shared among the threads of a \class{WorkerPool}.*/
+class ParallelTask
+{
+public:
+    virtual ~ParallelTask(){}
+
+    /*Execute the items from \argument{begin} up to but excluding
+     *\argument{end}. These are the items of block number
+     *\argument{block}. Calls for distinct blocks may be concurrent.*/
+    virtual void operator()(unsigned int begin, unsigned int end, unsigned int block) = 0;
+};
+
+class WorkerPool
+{
+public:
+    /*The pool of the application.*/
+    static WorkerPool* getInstance();
+
+    /*Stop and join the threads of the pool.*/
+    static void destroyInstance();
+
+    /*Set the number of threads that execute tasks, including the
+     *calling thread. A value of $0$ is taken to be $1$.*/
+    void setThreads(unsigned int);
+
+    /*Number of threads that execute tasks, including the calling
+     *thread.*/
+    unsigned int getThreads()const;
+
+    /*Number of blocks that a task over \argument{size} items with
+     *at least \argument{grain} items per block is divided into.*/
+    unsigned int blocks(unsigned int size, unsigned int grain = 1)const;
+
+    /*Execute the \argument{task} over \argument{size} items (see
+     *\method{blocks()}). The first block is executed by the calling
+     *thread. This returns once all the blocks have been
+     *executed. Tasks must not call \method{run()}.*/
+    void run(ParallelTask& task, unsigned int size, unsigned int grain = 1);
+private:
+    /*Construction of a pool with one thread.*/
+    WorkerPool();
+
+    /*Threads are stopped.*/
+    ~WorkerPool();
+
+    /*Body of the pool's threads. The argument is a \class{Worker}.*/
+    static void* work(void*);
+
+    /*Argument of a thread in \method{work()}.*/
+    struct Worker
+    {
+        WorkerPool* pool;
+
+        /*Block executed by this thread.*/
+        unsigned int block;
+
+        /*Last task generation executed by this thread.*/
+        unsigned int seen;
+
+        pthread_t thread;
+    };
+
+    /*Stop and join all the \member{workers}.*/
+    void stop();
+
+    /*The pool of the application.*/
+    static WorkerPool* instance;
+
+    /*Threads other than the calling thread.*/
+    vector<Worker*> workers;
+
+    /*Guards all the following members.*/
+    pthread_mutex_t mutex;
+
+    /*Signalled when a task is posted or the workers are to stop.*/
+    pthread_cond_t posted;
+
+    /*Signalled when the last worker completes its block.*/
+    pthread_cond_t completed;
+
+    /*Task being executed.*/
+    ParallelTask* task;
+
+    /*Number of items of the \member{task}.*/
+    unsigned int size;
+
+    /*Number of blocks of the \member{task}.*/
+    unsigned int taskBlocks;
+
+    /*Incremented whenever a task is posted.*/
+    unsigned int generation;
+
+    /*Number of workers that have yet to complete the current task.*/
+    unsigned int pending;
+
+    /*Should the workers stop?*/
+    bool stopping;
+
+    /*Ensure that a \class{WorkerPool} cannot be copied.*/
+    WorkerPool(const WorkerPool&);
+    WorkerPool& operator=(const WorkerPool&);
+};
+
+#endif
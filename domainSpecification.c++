@@ -170,9 +170,9 @@ void DomainSpecification::addSpecComponent(action s, ActionSpecification::CPTS*
     actionSpecification->addSpecComponent(s, cpt);
 }
 
-unsigned int DomainSpecification::memory()const
+unsigned long long DomainSpecification::memory()const
 {
-    unsigned int size = sizeof(*this);
+    unsigned long long size = sizeof(*this);
     
     size += rewardSpecification->memory();
 
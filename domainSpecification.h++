@@ -48,6 +48,11 @@ namespace MDP
         /*Set containment type for state characterising propositions.*/
         typedef std::set<proposition> PropositionSet;
 
+        /*Approximate number of bytes taken by a node of a
+         *\type{PropositionSet}, or of another standard tree, besides
+         *its element: a colour and three links.*/
+        static const unsigned int treeNodeOverhead = 4 * sizeof(void*);
+
         /*Domain construction achieves the following:
          *
          *\begin{itemize}
@@ -132,9 +137,9 @@ namespace MDP
         void addSpecComponent(action s, ActionSpecification::CPTS* cpt);
 
         /*Approximately the amount of memory taken by this
-         *specification. The result is a number of Kb. The
+         *specification. The result is a number of bytes. The
          *\member{actionSpecification} is ignored.*/
-        virtual unsigned int memory()const;
+        virtual unsigned long long memory()const;
 
         /*Print this domain specification to the output stream.  The
          *\member{startStatePropositions},
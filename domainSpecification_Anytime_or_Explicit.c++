@@ -29,10 +29,15 @@ using namespace MDP;
          */
 
 explicitDomainSpecification::explicitDomainSpecification
-(const DomainSpecification& domSpec)
+(const DomainSpecification& domSpec, bool pooled)
     :DomainSpecification(domSpec),
+     arena(pooled ? new Arena : 0),
+     formulaTable(new FormulaTable),
+     allStatesSet(formulaTable, propositions),
      initialisedStateStore(false)
 {
+    Scope scope(arena, formulaTable);
+
     startState = new eState(startStatePropositions, *rewardSpecification);
     fringeStates.insert(startState);
 }
@@ -43,14 +48,33 @@ explicitDomainSpecification::explicitDomainSpecification
 
 explicitDomainSpecification::~explicitDomainSpecification()
 {
-    /*Find all states $allStates$ in the state space.*/ 
-    vector<eState*> allStates;    
-    allStates = getStates(allStates);
+    {
+        Scope scope(arena, formulaTable);
 
-    for(vector<eState*>::iterator p = allStates.begin()
-            ; p != allStates.end()
-            ; ++p)
-        delete (*p);
+        /*Find all states $allStates$ in the state space.*/ 
+        vector<eState*> allStates;    
+        allStates = getStates(allStates);
+
+        /*Blocks are returned to the free lists of the \member{arena},
+          not the heap.*/
+        for(vector<eState*>::iterator p = allStates.begin()
+                ; p != allStates.end()
+                ; ++p)
+            delete (*p);
+
+        for(StateLabelling::iterator label = nmrsLabels.begin()
+                ; label != nmrsLabels.end()
+                ; ++label)
+            delete label->second;
+
+        /*The canonical formulae of the labels are freed once the
+          labels are.*/
+        delete formulaTable;
+    }
+
+    /*The chunks of the \member{arena} are freed together.*/
+    if(0 != arena)
+        arena->release();
 }
 
         /*
@@ -59,6 +83,8 @@ explicitDomainSpecification::~explicitDomainSpecification()
 
 void explicitDomainSpecification::preprocess(const Preprocessor& preprocessor)
 {
+    Scope scope(arena, formulaTable);
+
     /*Preprocess the old fringe.*/
     setFringe( preprocessor(fringeStates, *this) );
 }
@@ -66,6 +92,8 @@ void explicitDomainSpecification::preprocess(const Preprocessor& preprocessor)
 void explicitDomainSpecification::expandFringe(eState* stateToExpand,
                                                const Expansion& expansion)
 {   
+    Scope scope(arena, formulaTable);
+
     /*Calculate the possible state transitions from
       \argument{stateToExpand} given this specification.*/
     StateTransitionMatrices* stateTransitionMatrices
@@ -101,6 +129,8 @@ bool explicitDomainSpecification::removeImpossibleStates()
       \method{containsImpossibilities();}). Assume that all states
       remain.*/
     bool result = false;
+
+    Scope scope(arena, formulaTable);
     
     /*Are some impossible actions removed?*/
     if(removeImpossibleActions())
@@ -180,7 +210,7 @@ bool explicitDomainSpecification::removeImpossibleStates()
                 fringeStates.erase(*state);
                 domainStates.erase(*state);
                 
-                allStatesSet.erase(**state);
+                allStatesSet.erase(*state);
                 
                 delete *state;
             }
@@ -224,7 +254,17 @@ bool explicitDomainSpecification::removeImpossibleActions()
                   fringe.*/
                 if(fringeStates.end() ==
                    fringeStates.find(dynamic_cast<eState*>(*state)))
+                {
+                    /*The possibility of a state is part of its key in
+                      the \member{allStatesSet}.*/
+                    if(initialisedStateStore)
+                        allStatesSet.erase(*state);
+                    
                     (*state)->calculatePossibility();
+                    
+                    if(initialisedStateStore)
+                        allStatesSet.insert(*state);
+                }
                 
                 containsImpossibilities = !(*state)->isPossible();
             }/*Removal of impossible states from the state space shall
@@ -246,8 +286,7 @@ void explicitDomainSpecification::addToFringe(StateTransitionMatrices& possibleN
         for(vector<eState*>::const_iterator state = allStates.begin()
                 ; state != allStates.end()
                 ; ++state)
-            //(allStatesSet[(*state)->toString(true)])[**state] = *state;
-            allStatesSet[**state] = *state;
+            allStatesSet.insert(*state);
     }
     
     /*For each maplet or action in the \argument{possibleNewStates}
@@ -266,20 +305,15 @@ void explicitDomainSpecification::addToFringe(StateTransitionMatrices& possibleN
             if(0 == tmp)
                 assert(0);
 
-            //map<eState, eState*>::iterator id = (allStatesSet[tmp->toString(true)]).find(*tmp);
-            map<eState, eState*>::iterator id = allStatesSet.find(*tmp);
+            /*Either $tmp$ is stored or an equal state $id$ is found.*/
+            eState *id = allStatesSet.findOrInsert(tmp);
             
-            //if((allStatesSet[tmp->toString(true)]).end() == id)
-            if(allStatesSet.end() == id)
-            {
+            if(0 == id)
                 fringeStates.insert(tmp);/*Add to fringe.*/
-                //(allStatesSet[tmp->toString(true)])[*tmp] = tmp;
-                allStatesSet[*tmp] = tmp;
-            }
             else
             {
                 delete pair->second;
-                pair->second = id->second;
+                pair->second = id;
             }
             
         }
@@ -295,6 +329,8 @@ void explicitDomainSpecification::setFringe(const eStateSet& newFringe)
 
 void explicitDomainSpecification::allAreNMRS()
 {
+    Scope scope(arena, formulaTable);
+
     /*Find $allStates$ in the state space.*/ 
     vector<eState*> allStates;    
     allStates = getStates(allStates);
@@ -310,11 +346,12 @@ void explicitDomainSpecification::allAreNMRS()
             domainStates.erase(*state);
             fringeStates.erase(*state);
             
-            allStatesSet.erase(**state);
-            
             delete *state;
         }
-    /*\member{allStatesSet} should be empty.*/
+    
+    /*The states were changed by the preprocessor so they are not
+      erased one at a time (see \method{StateStore::erase()}).*/
+    allStatesSet.clear();
     initialisedStateStore = false;
 }
 
@@ -464,26 +501,60 @@ Policy* explicitDomainSpecification::getPolicy()
     return &policy;
 }
 
-unsigned int explicitDomainSpecification::memory()const
+unsigned long long explicitDomainSpecification::memory()const
 {
-    unsigned int size = DomainSpecification::memory()
+    unsigned long long size = DomainSpecification::memory()
         + sizeof(*this)
         - sizeof(DomainSpecification);
 
-    size += sizeof(startState);
+    size += allStatesSet.memory() - sizeof(allStatesSet);
 
-    /*Find all states $allStates$ in the state space.*/ 
-    vector<eState*> allStates;    
+    vector<eState*> allStates;
     allStates = getStates(allStates);
 
-    for(vector<eState*>::const_iterator p = allStates.begin()
-        ; p != allStates.end()
-        ; ++p)
-        size += (*p)->memory();
+    /*The states, their transitions, labels and formulae are counted
+      by the arena as they are allocated. Only the parts of the states
+      kept on the heap are estimated.*/
+    if(0 != arena)
+    {
+        size += arena->getBytes();
+
+        for(vector<eState*>::const_iterator p = allStates.begin()
+                ; p != allStates.end()
+                ; ++p)
+            size += (*p)->heapMemory();
+    }
+    else
+    {
+        for(vector<eState*>::const_iterator p = allStates.begin()
+                ; p != allStates.end()
+                ; ++p)
+            size += (*p)->memory();
+
+        /*Those of the canonical formulae are counted by their base.*/
+        size += formulaTable->size() * sizeof(formula);
+    }
+
+    for(StateLabelling::const_iterator label = nmrsLabels.begin()
+            ; label != nmrsLabels.end()
+            ; ++label)
+    {
+        if(0 == arena)
+            size += sizeof(*label->second);
+
+        size += DomainSpecification::treeNodeOverhead
+            + sizeof(*label)
+            + label->second->heapMemory();
+    }
     
     return size;
 }
 
+const Arena* explicitDomainSpecification::getArena()const
+{
+    return arena;
+}
+
 unsigned int explicitDomainSpecification::numberOfStates()const
 {
     return domainStates.size() + fringeStates.size();
@@ -20,6 +20,21 @@
  *
  * An explicit domain specification is one in which states are
  * represented explicitly.
+ *
+ * The states of the domain, their transitions and reward labels are
+ * allocated from the \class{Arena} of the specification. The arena is
+ * current while the specification creates or deletes states, and is
+ * released with the specification. The proposition sets of the states
+ * and the containers of their labels are of types shared with the
+ * structured solution methods, and are kept on the heap. Destruction
+ * of a specification thus still deletes its states one by one, though
+ * their blocks go to the free lists of the arena and its chunks are
+ * freed together. A specification may be made without an arena, so
+ * that the effect of the arena can be measured.
+ *
+ * The formulae of the reward labels are shared through the
+ * \class{FormulaTable} of the specification, which is current
+ * alongside the arena and is freed with the specification.
  **/
 #ifndef DOMAIN_ANYTIME_EXPLICIT_SPEC
 #define DOMAIN_ANYTIME_EXPLICIT_SPEC
@@ -27,14 +42,8 @@
 #include"SpecificationTypes.h++"
 #include"Expansion.h++"
 #include"Preprocessors.h++"
-
-// #include<hash_map.h>
-// struct string_hash {
-//     size_t operator() (const string& key) const {
-//         hash<const char*> H;
-//         return H(key.c_str());
-//     }
-// };
+#include"StateStore.h++"
+#include"formulaHashConsing.h++"
 
 namespace MDP
 {
@@ -45,8 +54,10 @@ namespace MDP
          *Construction
          */
         
-        /*Construction evaluates the start state.*/
-        explicitDomainSpecification(const DomainSpecification& domSpec);
+        /*Construction evaluates the start state. The states are
+         *allocated from an \class{Arena} if \argument{pooled}, else
+         *on the heap.*/
+        explicitDomainSpecification(const DomainSpecification& domSpec, bool pooled = true);
 
         /*Free resources taken by this specification.*/
         ~explicitDomainSpecification();
@@ -133,9 +144,19 @@ namespace MDP
         /*Get a handle to this domains policy.*/
         Policy* getPolicy();
         
-        /*Approximately the amount of memory taken by this
-         *specification. The result is a number of Kb.*/
-        unsigned int memory()const;
+        /*Amount of memory taken by this specification. The blocks
+         *allocated from the \member{arena} are counted as they are
+         *allocated, and the \member{allStatesSet} by its
+         *capacity. The states are visited to estimate the proposition
+         *sets and label containers, which are on the heap (see
+         *\method{State::heapMemory()}). Without an arena the whole of
+         *each state is estimated, thus the two results are close but
+         *not equal. The result is a number of bytes.*/
+        unsigned long long memory()const;
+
+        /*Arena from which the states of this specification are
+         *allocated, $0$ if they are allocated on the heap.*/
+        const Arena* getArena()const;
 
         /*Number of states.*/
         unsigned int numberOfStates()const;
@@ -180,9 +201,31 @@ namespace MDP
         /*Current policy.*/
         Policy policy;
     private:
-        /*Storage for all domain states.*/
-        map<eState, eState*> allStatesSet;
-        //hash_map<string, map<eState, eState*>, string_hash> allStatesSet;
+        /*The \member{arena} and \member{formulaTable} are current in
+         *the calling thread during the life of a \class{Scope}.*/
+        class Scope
+        {
+        public:
+            Scope(Arena* arena, FormulaTable* formulaTable)
+                :arenaScope(arena),
+                 formulaTableScope(formulaTable)
+                {}
+        private:
+            ArenaScope arenaScope;
+            FormulaTableScope formulaTableScope;
+        };
+        
+        /*Storage of the states, see file comment. $0$ if the states
+         *are allocated on the heap.*/
+        Arena* arena;
+
+        /*Canonical formulae of the reward labels, see file
+         *comment.*/
+        FormulaTable* formulaTable;
+
+        /*Hashed index of all domain states, used to find duplicates
+         *amongst newly generated successors (see \class{StateStore}).*/
+        StateStore allStatesSet;
 
         /*Has \member{allStatesSet} been initialised.*/
         bool initialisedStateStore;
@@ -0,0 +1,436 @@
+#!/usr/bin/ruby -w
+
+# Runs a matrix of problems through the solution methods of nmrdpp and
+# records, for each run, the wall and CPU time, the peak resident set
+# size, the number of states generated, the ADD node count, the
+# Bellman error after each iteration and the time taken to reach the
+# termination error. Results are written as JSON and CSV.
+#
+# State based methods may be run with the states allocated from an
+# arena and on the heap (arenas=on,off), to measure the effect of the
+# arena on time and peak resident memory.
+#
+# The problems are the PLTL and FLTL worlds of ../tests, worlds of
+# create-prob.rb at several sizes, and random domains built with
+# randomActionSpec and randomReward. Like create-prob.rb, this must be
+# run from the experiment directory.
+
+################# Methods ###################
+
+class SolutionMethod
+    attr_accessor :param
+
+    def initialize(param)
+	@param = param
+    end
+
+    def supports?(language)
+	true
+    end
+
+    # Error within which the algorithms terminate, nil where the
+    # termination does not depend on the error.
+    def threshold
+	param.epsilon * (1 - param.discount) / (2 * param.discount)
+    end
+end
+
+# State based methods expand an XMDP before or during solution.
+class StateBased <SolutionMethod
+    def setup(language)
+	language == 'PLTL' ? ["startStateRequired(1)"] : []
+    end
+
+    def preprocess(language)
+	language == 'PLTL' ? "preprocess('pltl')" : "preprocess('')"
+    end
+
+    def statistics
+	["'@@errors ' errorHistory",
+	    "'@@states ' domainStateSize",
+	    "'@@memory ' domainMemorySize"]
+    end
+end
+
+class ValueIterationMethod <StateBased
+    def ValueIterationMethod.method_name
+	'valIt'
+    end
+
+    def commands(language)
+	[preprocess(language), "expand",
+	    "valIt(#{param.discount}, #{param.epsilon})"]
+    end
+end
+
+class PolicyIterationMethod <StateBased
+    def PolicyIterationMethod.method_name
+	'polIt'
+    end
+
+    def commands(language)
+	[preprocess(language), "expand", "polIt(#{param.discount})"]
+    end
+
+    # Policy iteration terminates once the policy is unchanged, the
+    # error history is only the change of the policy value.
+    def threshold
+	nil
+    end
+end
+
+class LAOMethod <StateBased
+    def LAOMethod.method_name
+	'LAO'
+    end
+
+    def commands(language)
+	[preprocess(language),
+	    "LAO('valIt', #{param.discount}, #{param.epsilon})"]
+    end
+end
+
+# Structured methods only accept PLTL.
+class Structured <SolutionMethod
+    def setup(language)
+	[]
+    end
+
+    def supports?(language)
+	language == 'PLTL'
+    end
+end
+
+class SpuddMethod <Structured
+    def SpuddMethod.method_name
+	'spudd'
+    end
+
+    def commands(language)
+	["PLTLvarExpand", "spudd(#{param.discount}, #{param.epsilon})"]
+    end
+
+    def statistics
+	["'@@errors ' spuddDeltaHistory",
+	    "'@@nodes ' spuddValueNodes",
+	    "'@@states ' reachableStates"]
+    end
+end
+
+class TranslatorMethod <Structured
+    def TranslatorMethod.method_name
+	'PLTLvarExpand'
+    end
+
+    def commands(language)
+	["PLTLvarExpand"]
+    end
+
+    def statistics
+	["'@@begin variables'", "propositions", "'@@end'"]
+    end
+end
+
+$methods = Hash.new
+[ValueIterationMethod, PolicyIterationMethod, LAOMethod,
+    SpuddMethod, TranslatorMethod].each do | method |
+    $methods[method.method_name] = method
+end
+
+################# Problems ###################
+
+# A world file and the language of its reward specification.
+class Problem
+    attr_reader :name, :family, :n, :language, :world
+
+    def initialize(name, family, n, language, world)
+	@name = name
+	@family = family
+	@n = n
+	@language = language
+	@world = world
+    end
+end
+
+# World files are generated by create-prob.rb into test.world.
+def generate_world(name, arguments)
+    world = "bench-#{name}.world"
+    if !system("ruby create-prob.rb action=print-domain #{arguments} >/dev/null 2>&1") \
+	    || !File.exist?('test.world')
+	$stderr.puts "Could not generate #{name}, skipping"
+	return nil
+    end
+    File.rename('test.world', world)
+    world
+end
+
+def problem_matrix(param)
+    problems = Array.new
+
+    Dir['../tests/*.{pltl,fltl}'].sort.each do | world |
+	language = File.extname(world) == '.pltl' ? 'PLTL' : 'FLTL'
+	name = File.basename(world)
+	problems.push(Problem.new(name, 'tests', nil, language, world))
+    end
+
+    problems.push(Problem.new('factory.world', 'factory', nil, 'PLTL', 'factory.world'))
+
+    param.languages.each do | language |
+	param.worlds.each do | spec |
+	    action_spec, reward_spec = spec.split('/')
+	    param.sizes.each do | n |
+		name = "#{action_spec}-#{reward_spec}-#{language}-#{n}"
+		world = generate_world(name, "language=#{language} action_spec=#{action_spec} " +
+				       "reward_spec=#{reward_spec} n=#{n}")
+		problems.push(Problem.new(name, spec, n, language, world)) if world
+	    end
+	end
+
+	param.sizes.each do | n |
+	    param.seeds.each do | seed |
+		name = "RandomProblem-#{language}-#{n}-#{seed}"
+		world = generate_world(name, "language=#{language} problem=RandomProblem " +
+				       "n=#{n} seed=#{seed}")
+		problems.push(Problem.new(name, 'RandomProblem', n, language, world)) if world
+	    end
+	end
+    end
+
+    problems
+end
+
+################# Runs ###################
+
+def create_command(problem, method, arena, command_file)
+    test = open(command_file, "w")
+    test.puts method.setup(problem.language)
+    test.puts "arenaAllocation('false')" if arena == 'off'
+    test.puts "loadWorld('#{problem.world}')"
+    test.puts "startTimer\nstartCPUtimer"
+    test.puts method.commands(problem.language)
+    test.puts "stopTimer\nstopCPUtimer"
+    test.puts "'@@wall ' readTimer"
+    test.puts "'@@cpu ' readCPUtimer"
+    test.puts "'@@rss ' peakResidentMemory"
+    test.puts method.statistics
+    test.puts "quit"
+    test.close
+end
+
+# The first time and iteration at which the error is within the
+# threshold. Times are nil where the history has none, both are nil
+# where there is no threshold.
+def time_to_epsilon(history, threshold)
+    return [nil, nil] unless threshold
+    history.each_index do | i |
+	time, error = history[i]
+	return [time, i + 1] if error <= threshold
+    end
+    [nil, nil]
+end
+
+def run(problem, method, arena, param)
+    result = {
+	'problem' => problem.name,
+	'family' => problem.family,
+	'n' => problem.n,
+	'language' => problem.language,
+	'method' => method.class.method_name,
+	'arena' => arena,
+	'discount' => param.discount,
+	'epsilon' => param.epsilon
+    }
+
+    create_command(problem, method, arena, 'bench.cmd')
+
+    history = Array.new
+    variables = nil
+    IO.popen("#{param.nmrdpp} bench.cmd 2>/dev/null") do | output |
+	output.each_line do | line |
+	    if variables && line !~ /^@@end/
+		variables += 1 unless line.strip.empty?
+	    elsif line =~ /^@@wall *([-0-9\.e]+)/
+		result['wall_time'] = $1.to_f
+	    elsif line =~ /^@@cpu *([-0-9\.e]+)/
+		result['cpu_time'] = $1.to_f
+	    elsif line =~ /^@@rss *([-0-9\.e]+)/
+		result['peak_rss_mb'] = $1.to_f
+	    elsif line =~ /^@@states .*?(\d+)/
+		result['states'] = $1.to_i
+	    elsif line =~ /^@@memory .*?(\d+)/
+		result['domain_kb'] = $1.to_i
+	    elsif line =~ /^@@nodes *(\d+)/
+		result['add_nodes'] = $1.to_i
+	    elsif line =~ /^@@errors *(.*)$/
+		# errorHistory gives time:error pairs, spuddDeltaHistory errors.
+		history = $1.split(',').collect do | entry |
+		    fields = entry.split(':').collect { | x | x.to_f }
+		    fields.size == 2 ? fields : [nil, fields[0]]
+		end
+	    elsif line =~ /^@@begin variables/
+		variables = 0
+	    elsif line =~ /^@@end/
+		result['variables'] = variables
+		variables = nil
+	    end
+	end
+    end
+    result['status'] = $?.success? ? 'ok' : 'failed'
+
+    result['iterations'] = history.size
+    result['final_error'] = history.empty? ? nil : history.last[1]
+    result['error_history'] = history.collect { | time, error | error }
+    result['error_times'] = history.collect { | time, error | time }
+    result['time_to_epsilon'], result['iterations_to_epsilon'] =
+	time_to_epsilon(history, method.threshold)
+    result
+end
+
+################# Output ###################
+
+def json_value(value)
+    case value
+    when nil
+	'null'
+    when Array
+	'[' + value.collect { | x | json_value(x) }.join(', ') + ']'
+    when Numeric
+	value.to_s
+    else
+	'"' + value.to_s.gsub(/["\\]/) { | c | "\\" + c } + '"'
+    end
+end
+
+def write_json(results, filename)
+    out = open(filename, "w")
+    out.puts '['
+    out.puts results.collect { | result |
+	'  {' + result.keys.collect { | key |
+	    json_value(key) + ': ' + json_value(result[key])
+	}.join(', ') + '}'
+    }.join(",\n")
+    out.puts ']'
+    out.close
+end
+
+$csv_columns = ['problem', 'family', 'n', 'language', 'method', 'arena', 'discount', 'epsilon',
+    'status', 'wall_time', 'cpu_time', 'peak_rss_mb', 'states', 'domain_kb', 'add_nodes', 'variables',
+    'iterations', 'final_error', 'time_to_epsilon', 'iterations_to_epsilon']
+
+def write_csv(results, filename)
+    out = open(filename, "w")
+    out.puts $csv_columns.join(',')
+    results.each do | result |
+	out.puts $csv_columns.collect { | column |
+	    value = result[column]
+	    value.is_a?(String) && value =~ /[,"]/ ? '"' + value.gsub('"', '""') + '"' : value.to_s
+	}.join(',')
+    end
+    out.close
+end
+
+################# Command line ###################
+
+def show_help
+    $stderr.puts(
+		 "usage: ruby benchmark.rb option=value option=value...\n" +
+		 "  methods(#{$methods.keys.join(',')}): comma separated\n" +
+		 "  languages(PLTL,FLTL): languages of generated problems\n" +
+		 "  worlds(SpuddExpon/OneTrue,SpuddLinear/AllTrue): action_spec/reward_spec of create-prob.rb\n" +
+		 "  sizes(4,6,8): problem sizes of generated problems\n" +
+		 "  seeds(1,2): seeds of random problems\n" +
+		 "  arenas(on): state based methods allocate states from an arena (on) or the heap (off)\n" +
+		 "  discount(0.95) epsilon(0.05)\n" +
+		 "  output(benchmark): results are written to output.json and output.csv\n" +
+		 "  nmrdpp(../nmrdpp)\n" +
+		 "eg: ruby benchmark.rb methods=valIt,spudd sizes=4,5 output=quick")
+    exit(1)
+end
+
+class Parameters
+    attr_reader :solution_methods, :languages, :worlds, :sizes, :seeds, :arenas, :discount, :epsilon, :output, :nmrdpp
+
+    def initialize(args)
+	@solution_methods = $methods.keys
+	@languages = ['PLTL', 'FLTL']
+	@worlds = ['SpuddExpon/OneTrue', 'SpuddLinear/AllTrue']
+	@sizes = [4, 6, 8]
+	@seeds = [1, 2]
+	@arenas = ['on']
+	@discount = 0.95
+	@epsilon = 0.05
+	@output = 'benchmark'
+	@nmrdpp = '../nmrdpp'
+
+	args.each do | arg |
+	    if arg !~ /^(.*)=(.*)$/
+		$stderr.puts "all parameters are of the form option=value"
+		show_help
+	    end
+	    key, value = $1, $2
+	    case key
+	    when 'methods'
+		@solution_methods = value.split(',')
+	    when 'languages'
+		@languages = value.split(',')
+	    when 'worlds'
+		@worlds = value.split(',')
+	    when 'sizes'
+		@sizes = value.split(',').collect { | x | x.to_i }
+	    when 'seeds'
+		@seeds = value.split(',').collect { | x | x.to_i }
+	    when 'arenas'
+		@arenas = value.split(',')
+	    when 'discount'
+		@discount = value.to_f
+	    when 'epsilon'
+		@epsilon = value.to_f
+	    when 'output'
+		@output = value
+	    when 'nmrdpp'
+		@nmrdpp = value
+	    else
+		$stderr.puts "Unknown parameter \"#{key}\""
+		show_help
+	    end
+	end
+
+	@solution_methods.each do | method |
+	    if !$methods.has_key?(method)
+		$stderr.puts "Unknown method: \"#{method}\""
+		show_help
+	    end
+	end
+
+	@arenas.each do | arena |
+	    if !['on', 'off'].include?(arena)
+		$stderr.puts "Unknown arena: \"#{arena}\""
+		show_help
+	    end
+	end
+    end
+end
+
+show_help if ARGV.include?('--help')
+param = Parameters.new(ARGV)
+
+results = Array.new
+problem_matrix(param).each do | problem |
+    param.solution_methods.each do | name |
+	method = $methods[name].new(param)
+	next unless method.supports?(problem.language)
+
+	# The arena only concerns the states of state based methods.
+	arenas = method.is_a?(StateBased) ? param.arenas : [nil]
+	arenas.each do | arena |
+	    $stderr.print "#{problem.name} #{name}#{arena ? ' arena ' + arena : ''}: "
+	    result = run(problem, method, arena, param)
+	    $stderr.puts "#{result['status']} #{result['cpu_time']}"
+	    results.push(result)
+	end
+    end
+end
+
+write_json(results, "#{param.output}.json")
+write_csv(results, "#{param.output}.csv")
+exit(results.all? { | result | result['status'] == 'ok' } ? 0 : 1)
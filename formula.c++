@@ -22,6 +22,7 @@
 #include"formulaPrinter.h++"
 #include"formulaSize.h++"
 #include"formulaLength.h++"
+#include"Instrumentation.h++"
 
 using namespace Formula;
 
@@ -199,6 +200,7 @@ formula* PLTLformula::copy() const
 
 formula* PCformula::simplify() const
 {
+    ScopedTimer timer(Instrumentation::formulaSimplification);
     PCsimplifier<NA> simplifier;
     
     return givenTraversal<formula, PCsimplifier<NA> >(simplifier);
@@ -206,6 +208,7 @@ formula* PCformula::simplify() const
 
 formula* FLTLformula::simplify() const
 {
+    ScopedTimer timer(Instrumentation::formulaSimplification);
     FLTLsimplifier simplifier;
     
     return givenTraversal<formula, FLTLsimplifier >(simplifier);
@@ -213,6 +216,7 @@ formula* FLTLformula::simplify() const
 
 formula* PLTLformula::simplify() const
 {
+    ScopedTimer timer(Instrumentation::formulaSimplification);
     PLTLsimplifier simplifier;
     
     return givenTraversal<formula, PLTLsimplifier >(simplifier);
@@ -317,7 +321,7 @@ literal::~literal(){}
 
 const string& literal::getId() const {return id;}
 void literal::setId(string& str){id = str;}
-void literal::accept_() const {v->visit<literal>(this);}
+void literal::accept_(const Visitor& v) const {v.visit<literal>(this);}
 
 //  assLiteral
 
@@ -337,7 +341,7 @@ assLiteral::~assLiteral(){}
 
 bool assLiteral::getAssignment() const {return assignment;}
 
-void assLiteral::accept_() const {v->visit<assLiteral>(this);}
+void assLiteral::accept_(const Visitor& v) const {v.visit<assLiteral>(this);}
 
 // conj
 
@@ -345,7 +349,7 @@ conj::conj(const conj& c):binaryCommutative(c){PCformula::formula::negNormal = c
 conj::conj(formula *l, formula *r):binaryCommutative(l, r){PCformula::formula::negNormal = (l->isNegNormal() && r->isNegNormal());}
 conj::~conj(){}
 
-void conj::accept_() const {v->visit<conj>(this);}
+void conj::accept_(const Visitor& v) const {v.visit<conj>(this);}
 
 // disj
 
@@ -353,7 +357,7 @@ disj::disj(const disj& c):binaryCommutative(c){PCformula::formula::negNormal = c
 disj::disj(formula *l, formula *r):binaryCommutative(l, r){PCformula::formula::negNormal = l->isNegNormal() && r->isNegNormal();}
 disj::~disj(){}
 
-void disj::accept_() const {v->visit<disj>(this);}
+void disj::accept_(const Visitor& v) const {v.visit<disj>(this);}
 
 // iff
 
@@ -361,7 +365,7 @@ iff::iff(const iff& c):binaryCommutative(c){PCformula::formula::negNormal = c.is
 iff::iff(formula *l, formula *r):binaryCommutative(l, r){PCformula::formula::negNormal = l->isNegNormal() && r->isNegNormal();}
 iff::~iff(){}
 
-void iff::accept_() const {v->visit<iff>(this);}
+void iff::accept_(const Visitor& v) const {v.visit<iff>(this);}
 
 // imp
 
@@ -369,7 +373,7 @@ imp::imp(const imp& c):binary(c){PCformula::formula::negNormal = c.isNegNormal()
 imp::imp(formula *l, formula *r):binary(l, r){PCformula::formula::negNormal = l->isNegNormal() && r->isNegNormal();}
 imp::~imp(){}
 
-void imp::accept_() const {v->visit<imp>(this);}
+void imp::accept_(const Visitor& v) const {v.visit<imp>(this);}
 
 // lnot
 
@@ -377,7 +381,7 @@ lnot::lnot(const lnot& c):unary(c){PCformula::formula::negNormal = c.isNegNormal
 lnot::lnot(formula *f):unary(f){}
 lnot::~lnot(){}
 
-void lnot::accept_() const {v->visit<lnot>(this);}
+void lnot::accept_(const Visitor& v) const {v.visit<lnot>(this);}
 
 // nxt
 
@@ -385,7 +389,7 @@ nxt::nxt(const nxt& c):unary(c){FLTLformula::formula::negNormal = c.isNegNormal(
 nxt::nxt(formula *f):unary(f){FLTLformula::formula::negNormal = f->isNegNormal();}
 nxt::~nxt(){}
 
-void nxt::accept_() const {v->visit<nxt>(this);}
+void nxt::accept_(const Visitor& v) const {v.visit<nxt>(this);}
 
 // nxtDisj
 
@@ -393,7 +397,7 @@ nxtDisj::nxtDisj(const nxtDisj& c):summaryUnary(c){FLTLformula::formula::negNorm
 nxtDisj::nxtDisj(formula *f, unsigned int depth):summaryUnary(f, depth, 1){FLTLformula::formula::negNormal = f->isNegNormal();}
 nxtDisj::~nxtDisj(){}
 
-void nxtDisj::accept_() const {v->visit<nxtDisj>(this);}
+void nxtDisj::accept_(const Visitor& v) const {v.visit<nxtDisj>(this);}
 
 // nxtConj
 
@@ -401,7 +405,7 @@ nxtConj::nxtConj(const nxtConj& c):summaryUnary(c){FLTLformula::formula::negNorm
 nxtConj::nxtConj(formula *f, unsigned int depth):summaryUnary(f, depth, 2){FLTLformula::formula::negNormal = f->isNegNormal();}
 nxtConj::~nxtConj(){}
 
-void nxtConj::accept_() const {v->visit<nxtConj>(this);}
+void nxtConj::accept_(const Visitor& v) const {v.visit<nxtConj>(this);}
 
 // nxtNest
 
@@ -409,7 +413,7 @@ nxtNest::nxtNest(const nxtNest& c):summaryUnary(c){FLTLformula::formula::negNorm
 nxtNest::nxtNest(formula *f, unsigned int depth):summaryUnary(f, depth, 2){FLTLformula::formula::negNormal = f->isNegNormal();}
 nxtNest::~nxtNest(){}
 
-void nxtNest::accept_() const {v->visit<nxtNest>(this);}
+void nxtNest::accept_(const Visitor& v) const {v.visit<nxtNest>(this);}
 
 // fut
 
@@ -417,7 +421,7 @@ fut::fut(const fut& c):binary(c){FLTLformula::formula::negNormal = c.isNegNormal
 fut::fut(formula *l, formula *r):binary(l, r){FLTLformula::formula::negNormal = l->isNegNormal() && r->isNegNormal();}
 fut::~fut(){}
 
-void fut::accept_() const {v->visit<fut>(this);}
+void fut::accept_(const Visitor& v) const {v.visit<fut>(this);}
 
 // strFut
 
@@ -425,7 +429,7 @@ strFut::strFut(const strFut& c):binary(c){FLTLformula::formula::negNormal = c.is
 strFut::strFut(formula *l, formula *r):binary(l, r){FLTLformula::formula::negNormal = l->isNegNormal() && r->isNegNormal();}
 strFut::~strFut(){}
 
-void strFut::accept_() const {v->visit<strFut>(this);}
+void strFut::accept_(const Visitor& v) const {v.visit<strFut>(this);}
 
 // fbx
 
@@ -433,7 +437,7 @@ fbx::fbx(const fbx& c):unary(c){FLTLformula::formula::negNormal = c.isNegNormal(
 fbx::fbx(formula *f):unary(f){FLTLformula::formula::negNormal = f->isNegNormal();}
 fbx::~fbx(){}
 
-void fbx::accept_() const {v->visit<fbx>(this);}
+void fbx::accept_(const Visitor& v) const {v.visit<fbx>(this);}
 
 // fdi
 
@@ -441,7 +445,7 @@ fdi::fdi(const fdi& c):unary(c){FLTLformula::formula::negNormal = c.isNegNormal(
 fdi::fdi(formula *f):unary(f){FLTLformula::formula::negNormal = f->isNegNormal();}
 fdi::~fdi(){}
 
-void fdi::accept_() const {v->visit<fdi>(this);}
+void fdi::accept_(const Visitor& v) const {v.visit<fdi>(this);}
 
 //  dollars
 
@@ -449,7 +453,7 @@ dollars::dollars(const dollars& d){FLTLformula::formula::negNormal = true;}
 dollars::~dollars(){}
 dollars::dollars(){FLTLformula::formula::negNormal = true;}
 
-void dollars::accept_() const{v->visit<dollars>(this);}
+void dollars::accept_(const Visitor& v) const{v.visit<dollars>(this);}
 
 //  startStateProposition
 
@@ -462,8 +466,8 @@ assLiteral* startStateProposition::startStateAssignment()const
     return new assLiteral(true);
 }
 
-void startStateProposition::accept_() const
-{v->visit<startStateProposition>(this);}
+void startStateProposition::accept_(const Visitor& v) const
+{v.visit<startStateProposition>(this);}
 
 //  prv
 
@@ -476,7 +480,7 @@ assLiteral* prv::startStateAssignment()const
     return new assLiteral(false);
 }
 
-void prv::accept_() const {v->visit<prv>(this);}
+void prv::accept_(const Visitor& v) const {v.visit<prv>(this);}
 
 //  prvDisj
 
@@ -489,7 +493,7 @@ assLiteral* prvDisj::startStateAssignment()const
     return new assLiteral(false);
 }
 
-void prvDisj::accept_() const {v->visit<prvDisj>(this);}
+void prvDisj::accept_(const Visitor& v) const {v.visit<prvDisj>(this);}
 
 //  prvConj
 
@@ -502,7 +506,7 @@ assLiteral* prvConj::startStateAssignment()const
     return new assLiteral(false);
 }
 
-void prvConj::accept_() const {v->visit<prvConj>(this);}
+void prvConj::accept_(const Visitor& v) const {v.visit<prvConj>(this);}
 
 //  prvNest
 
@@ -515,7 +519,7 @@ assLiteral* prvNest::startStateAssignment()const
     return new assLiteral(false);
 }
 
-void prvNest::accept_() const {v->visit<prvNest>(this);}
+void prvNest::accept_(const Visitor& v) const {v.visit<prvNest>(this);}
 
 // snc
 
@@ -528,7 +532,7 @@ assLiteral* snc::startStateAssignment()const
     return new assLiteral(true);
 }
 
-void snc::accept_() const {v->visit<snc>(this);}
+void snc::accept_(const Visitor& v) const {v.visit<snc>(this);}
 
 // pbx
 
@@ -541,7 +545,7 @@ assLiteral* pbx::startStateAssignment()const
     return new assLiteral(true);
 }
 
-void pbx::accept_() const {v->visit<pbx>(this);}
+void pbx::accept_(const Visitor& v) const {v.visit<pbx>(this);}
 
 // pdi
 
@@ -554,4 +558,4 @@ assLiteral* pdi::startStateAssignment()const
     return new assLiteral(false);
 }
 
-void pdi::accept_() const {v->visit<pdi>(this);}
+void pdi::accept_(const Visitor& v) const {v.visit<pdi>(this);}
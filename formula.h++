@@ -33,6 +33,7 @@
 #define FORMULA
 
 #include"formulaVisitation.h++"
+#include"Arena.h++"
 #include<string>
 #include<cassert>
 
@@ -40,6 +41,8 @@ using namespace std;
 
 namespace Formula
 { 
+    class FormulaTable;
+
     /*Parent class for formulae and their subcomponents
      *(subformulae).*/
     class formula
@@ -47,25 +50,32 @@ namespace Formula
     public:
         /*A formula on construction is assumed not to be negation
          *normal.*/
-        formula():negNormal(false), v(0){}
+        formula():negNormal(false), table(0), nodeId(0){}
 
-        formula(const formula& f):negNormal(f.negNormal), v(0){}
+        /*A copy is never a canonical node.*/
+        formula(const formula& f):negNormal(f.negNormal), table(0), nodeId(0){}
 
-        formula(bool negNormal):negNormal(negNormal){}
+        formula(bool negNormal):negNormal(negNormal), table(0), nodeId(0){}
         
         /*Ensure derivation cleaning.*/
         virtual ~formula() {} 
 
+        /*Formula nodes are allocated from the current
+         *\class{Arena}.*/
+        static void* operator new(size_t size){return Arena::allocate(size);}
+        static void operator delete(void* node){Arena::deallocate(node);}
+
         /*Generic visitation for composite formula tree traversal is
          *publicly implemented only within the base class of all
-         *composites.*/
+         *composites. The \class{Visitor} lives on the stack of the
+         *call, so shared nodes can be visited by several threads at
+         *once.*/
         template<typename Visit>
         void accept(Visit v) const
             {
-                this->v = new Visitor;
-                this->v->setVisitor(v);
-                accept_();
-                delete this->v;
+                Visitor visitor;
+                visitor.setVisitor(v);
+                accept_(visitor);
             }
         
         /*\class{formula} equality is based on syntactic equality
@@ -100,6 +110,14 @@ namespace Formula
         
         /*Configure negation normality of the formula.*/
         void setNegNormal(bool);
+
+        /*The \class{FormulaTable} of which this is a canonical node,
+         *$0$ if this formula is private to its holder.*/
+        FormulaTable const* getTable() const{return table;}
+
+        /*Identity of this canonical node within its
+         *\class{FormulaTable}.*/
+        unsigned int getNodeId() const{return nodeId;}
         
         /*Negation normalise this formula. This method doesn't perform
          *a transformation but rather, the result is the
@@ -124,16 +142,23 @@ namespace Formula
          *operators from which the formula is composed.*/
         virtual unsigned int length() const = 0;
     protected:
+        /*Canonical nodes are registered by their table.*/
+        friend class FormulaTable;
+
         /*Is the formula negation normal?*/
         bool negNormal;
 
-        /*Visitation is the means by which the task of traversing
+        /*See \method{getTable()}.*/
+        FormulaTable* table;
+
+        /*See \method{getNodeId()}.*/
+        unsigned int nodeId;
+
+        /*Derivatives implement visitor acceptance (see accept()).
+         *Visitation is the means by which the task of traversing
          *composite formulae is delegated to a visitation object (see
          *\module{formulaVisitation}).*/
-        mutable Visitor *v;
-
-        /*Derivatives implement visitor acceptance (see accept()).*/
-        virtual void accept_() const = 0;
+        virtual void accept_(const Visitor& v) const = 0;
 	
         /*Traversal for formula structure with */
         template<typename Return, class Visitor>
@@ -159,6 +184,10 @@ namespace Formula
     class unary : public aggregate<formula*, OperatorIndexType>
     {
     public:
+        /*Shared subformulae are detached by the \class{FormulaTable}
+         *before its nodes are freed.*/
+        friend class FormulaTable;
+
         /*Copy constructor.*/
         unary(const unary& u);
 
@@ -250,6 +279,9 @@ namespace Formula
          *private members of a \class{binary} operator (its parent).*/
         friend class binaryCommutative;
 
+        /*See \class{unary}.*/
+        friend class FormulaTable;
+
         /*Copy constructor.*/
         binary(const binary& b);
 	
@@ -339,7 +371,7 @@ namespace Formula
         void setId(string& str);
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     private:
         string id;
     };
@@ -355,7 +387,7 @@ namespace Formula
         bool getAssignment() const;
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     private:
         bool assignment;
     };
@@ -370,7 +402,7 @@ namespace Formula
         ~conj();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     class disj 
@@ -383,7 +415,7 @@ namespace Formula
         ~disj();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
 
@@ -397,7 +429,7 @@ namespace Formula
         ~iff();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     class imp 
@@ -410,7 +442,7 @@ namespace Formula
         ~imp();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     class lnot 
@@ -423,7 +455,7 @@ namespace Formula
         ~lnot();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     /*FLTL formula*/
@@ -460,7 +492,7 @@ namespace Formula
         ~nxt();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
     
     /*Disjunction of the next operator.*/
@@ -474,7 +506,7 @@ namespace Formula
         ~nxtDisj();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     /*Conjunction of the next operator.*/
@@ -488,7 +520,7 @@ namespace Formula
         ~nxtConj();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
     
     /*Nested next operator.*/
@@ -502,7 +534,7 @@ namespace Formula
         ~nxtNest();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
   
     /*Week until*/
@@ -516,7 +548,7 @@ namespace Formula
         ~fut();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
   
     /*Strong until*/
@@ -530,7 +562,7 @@ namespace Formula
         ~strFut();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     /*Future box.*/
@@ -544,7 +576,7 @@ namespace Formula
         ~fbx();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     /*Future diamond.*/
@@ -558,7 +590,7 @@ namespace Formula
         ~fdi();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     /*Rewarding proposition.*/
@@ -571,7 +603,7 @@ namespace Formula
         ~dollars();
         virtual bool operator==(formula& f) const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     class PLTLformula 
@@ -617,7 +649,7 @@ namespace Formula
         bool operator==(formula& f) const;
         assLiteral* startStateAssignment()const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
     
     /*Previously.*/
@@ -632,7 +664,7 @@ namespace Formula
         virtual bool operator==(formula& f) const;
         assLiteral* startStateAssignment()const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     /*Disjunction of the previously operator.*/
@@ -647,7 +679,7 @@ namespace Formula
         virtual bool operator==(formula& f) const;
         assLiteral* startStateAssignment()const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     /*Conjunction of the previously operator.*/
@@ -662,7 +694,7 @@ namespace Formula
         virtual bool operator==(formula& f) const;
         assLiteral* startStateAssignment()const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
     
     /*Nested previously operator.*/
@@ -677,7 +709,7 @@ namespace Formula
         virtual bool operator==(formula& f) const;
         assLiteral* startStateAssignment()const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     /*Since.*/
@@ -692,7 +724,7 @@ namespace Formula
         virtual bool operator==(formula& f) const;
         assLiteral* startStateAssignment()const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     /*Past box.*/
@@ -707,7 +739,7 @@ namespace Formula
         virtual bool operator==(formula& f) const;
         assLiteral* startStateAssignment()const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 
     /*Past diamond.*/
@@ -722,7 +754,7 @@ namespace Formula
         virtual bool operator==(formula& f) const;
         assLiteral* startStateAssignment()const;
     protected:
-        void accept_() const;
+        void accept_(const Visitor& v) const;
     };
 }
 #endif
@@ -0,0 +1,534 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include<functional>
+#include<algorithm>
+#include<cstring>
+
+#include"formulaHashConsing.h++"
+
+using namespace Formula;
+using namespace std;
+
+/*******************************************************Key*/
+
+FormulaTable::Key::Key(const type_info& type,
+                       bool negNormal,
+                       formula const* left,
+                       formula const* right,
+                       unsigned int extra,
+                       const string& id)
+    :type(&type),
+     negNormal(negNormal),
+     left(left),
+     right(right),
+     extra(extra),
+     id(id)
+{}
+
+bool FormulaTable::Key::operator<(const Key& key)const
+{
+    less<formula const*> before;
+
+    if(*type != *key.type)
+        return type->before(*key.type);
+    if(negNormal != key.negNormal)
+        return negNormal < key.negNormal;
+    if(left != key.left)
+        return before(left, key.left);
+    if(right != key.right)
+        return before(right, key.right);
+    if(extra != key.extra)
+        return extra < key.extra;
+    return id < key.id;
+}
+
+bool FormulaTable::TraversalKey::operator<(const TraversalKey& key)const
+{
+    less<formula const*> before;
+
+    if(*traverser != *key.traverser)
+        return traverser->before(*key.traverser);
+    if(form != key.form)
+        return before(form, key.form);
+    if(assignment != key.assignment)
+        return assignment < key.assignment;
+    return filter < key.filter;
+}
+
+/*******************************************************FormulaTable*/
+
+/*Table current in the calling thread (see \class{FormulaTableScope}).*/
+static __thread FormulaTable* current = 0;
+
+/*Hash of the argument bytes, given the hash of what precedes them
+  (FNV-1a).*/
+static unsigned long hashBytes(unsigned long hash, const char* bytes, size_t size)
+{
+    for(size_t i = 0; i != size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= 1099511628211UL;
+    }
+
+    return hash;
+}
+
+/*Hash of the argument value, given the hash of what precedes it.*/
+static unsigned long hashValue(unsigned long hash, unsigned long value)
+{
+    return hashBytes(hash, reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+FormulaTable* FormulaTable::getInstance()
+{
+    return current;
+}
+
+bool FormulaTable::comparable(formula const* left, formula const* right)
+{
+    FormulaTable const* table = left->getTable();
+
+    if(0 == table || table != right->getTable())
+        return false;
+
+    pthread_rwlock_rdlock(&table->lock);
+    bool result = table->nodes[left->getNodeId()].normal
+        && table->nodes[right->getNodeId()].normal;
+    pthread_rwlock_unlock(&table->lock);
+
+    return result;
+}
+
+FormulaTable::FormulaTable()
+    :nextFilter(0)
+{
+    pthread_rwlock_init(&lock, 0);
+}
+
+FormulaTable::~FormulaTable()
+{
+    /*Subformulae are shared, thus they are detached before the nodes
+      are freed.*/
+    for(vector<Node>::iterator node = nodes.begin()
+            ; node != nodes.end()
+            ; ++node)
+    {
+        unary* un = dynamic_cast<unary*>(node->form);
+        binary* bin = dynamic_cast<binary*>(node->form);
+
+        if(0 != un)
+            un->f = 0;
+        if(0 != bin)
+            bin->l = bin->r = 0;
+
+        delete node->form;
+    }
+
+    pthread_rwlock_destroy(&lock);
+}
+
+formula const* FormulaTable::intern(formula const* form)
+{
+    if(isCanonical(form))
+        return form;
+
+    pthread_rwlock_wrlock(&lock);
+    formula const* result = intern_(form);
+    pthread_rwlock_unlock(&lock);
+
+    return result;
+}
+
+formula* FormulaTable::intern_(formula const* form)
+{
+    if(isCanonical(form))
+        return const_cast<formula*>(form);
+
+    /*Interning is by a visitor suited to the type of the root.*/
+    if(0 != dynamic_cast<FLTLformula const*>(form))
+    {
+        FLTLconser conser(this);
+        conser.initBuild();
+        form->accept(&conser);
+        return conser.getBuild();
+    }
+    else if(0 != dynamic_cast<PLTLformula const*>(form))
+    {
+        PLTLconser conser(this);
+        conser.initBuild();
+        form->accept(&conser);
+        return conser.getBuild();
+    }
+
+    PCconser<NA> conser(this);
+    conser.initBuild();
+    form->accept(&conser);
+    return conser.getBuild();
+}
+
+bool FormulaTable::isCanonical(formula const* form)const
+{
+    return this == form->getTable();
+}
+
+formula const* FormulaTable::simplify(formula const* form)
+{
+    formula const* result = 0;
+    
+    pthread_rwlock_rdlock(&lock);
+    map<formula const*, formula const*>::const_iterator p
+        = simplifications.find(form);
+    if(simplifications.end() != p)
+        result = p->second;
+    pthread_rwlock_unlock(&lock);
+
+    if(0 != result)
+        return result;
+
+    /*The simplification is calculated without the lock, as the
+      canonical argument does not change.*/
+    formula* tmp = form->simplify();
+
+    pthread_rwlock_wrlock(&lock);
+    result = intern_(tmp);
+    simplifications[form] = result;
+    pthread_rwlock_unlock(&lock);
+    
+    delete tmp;
+
+    return result;
+}
+
+formula const* FormulaTable::negate(formula const* form)
+{
+    /*A negation is not negation normal on construction (see
+      \class{lnot}).*/
+    Key key(typeid(lnot), false, form);
+    
+    pthread_rwlock_wrlock(&lock);
+    formula* result = find(key);
+    if(0 == result)
+        result = insert(key, new lnot(const_cast<formula*>(form)));
+    pthread_rwlock_unlock(&lock);
+
+    return result;
+}
+
+unsigned int FormulaTable::internFilter(const string& signature)
+{
+    unsigned int id;
+    
+    pthread_rwlock_wrlock(&lock);
+    
+    map<string, unsigned int>::const_iterator p = filters.find(signature);
+
+    if(filters.end() != p)
+        id = p->second;
+    else
+    {
+        /*Identifiers are not reused, thus the traversals memoised
+          against a forgotten signature are never found again.*/
+        if(maximumTraversals <= filters.size())
+            filters.clear();
+        
+        id = nextFilter++;
+        filters[signature] = id;
+    }
+    
+    pthread_rwlock_unlock(&lock);
+
+    return id;
+}
+
+bool FormulaTable::findTraversal(const type_info& traverser,
+                                 formula const* form,
+                                 unsigned long long assignment,
+                                 unsigned int filter,
+                                 Traversal& traversal)const
+{
+    TraversalKey key = {&traverser, form, assignment, filter};
+
+    pthread_rwlock_rdlock(&lock);
+    
+    map<TraversalKey, Traversal>::const_iterator p = traversals.find(key);
+    bool found = traversals.end() != p;
+    if(found)
+        traversal = p->second;
+    
+    pthread_rwlock_unlock(&lock);
+
+    return found;
+}
+
+void FormulaTable::addTraversal(const type_info& traverser,
+                                formula const* form,
+                                unsigned long long assignment,
+                                unsigned int filter,
+                                const Traversal& traversal)
+{
+    TraversalKey key = {&traverser, form, assignment, filter};
+
+    pthread_rwlock_wrlock(&lock);
+
+    /*The memoised traversals are bounded, the canonical nodes they
+      refer to are not freed.*/
+    if(maximumTraversals <= traversals.size())
+        traversals.clear();
+    
+    traversals[key] = traversal;
+    
+    pthread_rwlock_unlock(&lock);
+}
+
+formula* FormulaTable::find(const Key& key)const
+{
+    map<Key, formula*>::const_iterator p = index.find(key);
+
+    if(index.end() == p)
+        return 0;
+
+    return p->second;
+}
+
+formula* FormulaTable::insert(const Key& key, formula* form)
+{
+    Node node;
+    vector<formula const*> atoms;
+    
+    node.form = form;
+    node.normal = key.negNormal;
+
+    /*The hash is that of the type, the mark and operands of the node.*/
+    node.hash = hashBytes(14695981039346656037UL,
+                          key.type->name(),
+                          strlen(key.type->name()));
+    node.hash = hashValue(node.hash, key.negNormal);
+    node.hash = hashValue(node.hash, key.extra);
+    node.hash = hashBytes(node.hash, key.id.data(), key.id.size());
+
+    if(typeid(literal) == *key.type)
+        atoms.push_back(form);
+
+    /*The atoms of a node are those of its operands.*/
+    formula const* operands[] = {key.left, key.right};
+    for(unsigned int i = 0; i != 2; ++i)
+    {
+        if(0 == operands[i])
+        {
+            node.hash = hashValue(node.hash, 0);
+            continue;
+        }
+        
+        const Node& operand = nodes[operands[i]->getNodeId()];
+        const vector<formula const*>& operandAtoms = atomLists[operand.atoms];
+        vector<formula const*> tmp;
+
+        set_union(atoms.begin(), atoms.end(),
+                  operandAtoms.begin(), operandAtoms.end(),
+                  back_inserter(tmp));
+        atoms.swap(tmp);
+        
+        node.hash = hashValue(node.hash, operand.hash);
+        node.normal = node.normal && operand.normal;
+    }
+
+    node.atoms = internAtoms(atoms);
+    
+    form->table = this;
+    form->nodeId = nodes.size();
+    
+    nodes.push_back(node);
+    index[key] = form;
+
+    return form;
+}
+
+bool FormulaTable::precedes(formula const* left, formula const* right)const
+{
+    if(left == right)
+        return false;
+    
+    const Node& leftNode = nodes[left->getNodeId()];
+    const Node& rightNode = nodes[right->getNodeId()];
+
+    if(leftNode.hash != rightNode.hash)
+        return leftNode.hash < rightNode.hash;
+
+    /*Distinct structures of equal hash are rare, they are ordered by
+      their place in the table.*/
+    return left->getNodeId() < right->getNodeId();
+}
+
+unsigned int FormulaTable::internAtoms(const vector<formula const*>& atoms)
+{
+    map<vector<formula const*>, unsigned int>::const_iterator p
+        = atomListIndex.find(atoms);
+
+    if(atomListIndex.end() != p)
+        return p->second;
+
+    unsigned int id = atomLists.size();
+    atomLists.push_back(atoms);
+    atomListIndex[atoms] = id;
+
+    return id;
+}
+
+unsigned int FormulaTable::size()const
+{
+    pthread_rwlock_rdlock(&lock);
+    unsigned int result = nodes.size();
+    pthread_rwlock_unlock(&lock);
+    
+    return result;
+}
+
+unsigned int FormulaTable::numberOfTraversals()const
+{
+    pthread_rwlock_rdlock(&lock);
+    unsigned int result = traversals.size();
+    pthread_rwlock_unlock(&lock);
+    
+    return result;
+}
+
+/*******************************************************FormulaTableScope*/
+
+FormulaTableScope::FormulaTableScope(FormulaTable* table)
+    :previous(current)
+{
+    current = table;
+}
+
+FormulaTableScope::~FormulaTableScope()
+{
+    current = previous;
+}
+
+/*******************************************************FLTLconser*/
+
+void FLTLconser::visit(const nxt& f)
+{
+    cons(f[0]);
+    consUnary<nxt>(item);
+}
+
+void FLTLconser::visit(const nxtDisj& f)
+{
+    cons(f[0]);
+    consSummary<nxtDisj>(item, f.getDepth());
+}
+
+void FLTLconser::visit(const nxtConj& f)
+{
+    cons(f[0]);
+    consSummary<nxtConj>(item, f.getDepth());
+}
+
+void FLTLconser::visit(const nxtNest& f)
+{
+    cons(f[0]);
+    consSummary<nxtNest>(item, f.getDepth());
+}
+
+void FLTLconser::visit(const fut& f)
+{
+    formula* tmp;
+    cons(f[0]);
+    tmp = item;
+    cons(f[1]);
+    consBinary<fut>(tmp, item);
+}
+
+void FLTLconser::visit(const strFut& f)
+{
+    formula* tmp;
+    cons(f[0]);
+    tmp = item;
+    cons(f[1]);
+    consBinary<strFut>(tmp, item);
+}
+
+void FLTLconser::visit(const fbx& f)
+{
+    cons(f[0]);
+    consUnary<fbx>(item);
+}
+
+void FLTLconser::visit(const fdi& f)
+{
+    cons(f[0]);
+    consUnary<fdi>(item);
+}
+
+void FLTLconser::visit(const dollars& dol)
+{
+    consLeaf<dollars>(dol);
+}
+
+/*******************************************************PLTLconser*/
+
+void PLTLconser::visit(const startStateProposition& f)
+{
+    consLeaf<startStateProposition>(f);
+}
+
+void PLTLconser::visit(const prv& f)
+{
+    cons(f[0]);
+    consUnary<prv>(item);
+}
+
+void PLTLconser::visit(const prvDisj& f)
+{
+    cons(f[0]);
+    consSummary<prvDisj>(item, f.getDepth());
+}
+
+void PLTLconser::visit(const prvConj& f)
+{
+    cons(f[0]);
+    consSummary<prvConj>(item, f.getDepth());
+}
+
+void PLTLconser::visit(const prvNest& f)
+{
+    cons(f[0]);
+    consSummary<prvNest>(item, f.getDepth());
+}
+
+void PLTLconser::visit(const snc& f)
+{
+    formula* tmp;
+    cons(f[0]);
+    tmp = item;
+    cons(f[1]);
+    consBinary<snc>(tmp, item);
+}
+
+void PLTLconser::visit(const pbx& f)
+{
+    cons(f[0]);
+    consUnary<pbx>(item);
+}
+
+void PLTLconser::visit(const pdi& f)
+{
+    cons(f[0]);
+    consUnary<pdi>(item);
+}
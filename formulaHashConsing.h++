@@ -0,0 +1,396 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+/*
+ * \paragraph{:Purpose:}
+ *
+ * Hash--consing of formulae. The \class{FormulaTable} keeps exactly
+ * one immutable node for every structurally distinct formula it has
+ * seen, and structurally equal subformulae of those nodes are shared.
+ * The operands of commutative connectives are put in a canonical
+ * order, thus two negation normal formulae interned by the table are
+ * equal (see \module{formulaEquality}) iff their canonical nodes are
+ * the same pointer.
+ *
+ * Canonical nodes are immutable and shared, by the table and by the
+ * reward specifications that hold them, thus they are never deleted
+ * by their holders (see \method{RewardSpecification::releaseFormula()})
+ * and are freed with the table.
+ *
+ * Canonical nodes are the basis of memoised sequence traversal (see
+ * \method{RewardSpecification::sequenceTraversal()}). The result of
+ * progressing or regressing a formula, and the simplification of that
+ * result, is recorded against the canonical node, the assignment of
+ * the state characterising propositions to the atoms of that node and
+ * the \class{BuildFilter} used, so that states sharing a label only
+ * traverse it once. The number of memoised traversals is bounded.
+ *
+ * Interning is achieved by visitation (see \class{PCconser}).
+ *
+ * A table is owned by the domain whose labels it holds (see
+ * \class{explicitDomainSpecification}), and is current in a thread
+ * during the life of a \class{FormulaTableScope}. A table may be
+ * used by several threads at once.
+ **/
+#ifndef FORMULA_HASH_CONSING
+#define FORMULA_HASH_CONSING
+
+#include"formulaVisitation.h++"
+#include"formula.h++"
+
+#include<pthread.h>
+
+#include<typeinfo>
+#include<string>
+#include<vector>
+#include<map>
+
+namespace Formula
+{
+    template<class C> class PCconser;
+    class FLTLconser;
+    class PLTLconser;
+
+    class FormulaTable
+    {
+    public:
+        /*Identification of a formula node given the canonical nodes
+         *of its subformulae and whether it is marked negation normal
+         *(see \method{formula::isNegNormal()}). The \member{extra} is the depth of a
+         *\class{summaryUnary} or the assignment of an
+         *\class{assLiteral}, the \member{id} is that of a
+         *\class{literal}.*/
+        struct Key
+        {
+            Key(const std::type_info&,
+                bool negNormal,
+                formula const* left = 0,
+                formula const* right = 0,
+                unsigned int extra = 0,
+                const std::string& id = std::string());
+
+            std::type_info const* type;
+            bool negNormal;
+            formula const* left;
+            formula const* right;
+            unsigned int extra;
+            std::string id;
+
+            bool operator<(const Key&)const;
+        };
+
+        /*The memoised result of a sequence traversal (see file
+         *comment). \member{build} is the traversed formula and
+         *\member{simplified} its simplification, both canonical.*/
+        struct Traversal
+        {
+            formula const* build;
+            formula const* simplified;
+            bool rewarding;
+        };
+
+        /*The table current in the calling thread (see
+         *\class{FormulaTableScope}), $0$ if there is none.*/
+        static FormulaTable* getInstance();
+
+        /*Are the arguments canonical nodes of one table, both
+         *negation normal? If so they are equal iff they are the same
+         *node.*/
+        static bool comparable(formula const*, formula const*);
+
+        /*Construction of an empty table.*/
+        FormulaTable();
+
+        /*Canonical nodes are freed.*/
+        ~FormulaTable();
+
+        /*Canonical node structurally equal to the argument. The
+         *argument is not retained. Interning a canonical node of
+         *this table is immediate.*/
+        formula const* intern(formula const*);
+
+        /*Is the argument a canonical node of this table?*/
+        bool isCanonical(formula const*)const;
+
+        /*Canonical simplification (see \method{formula::simplify()})
+         *of the argument canonical node.*/
+        formula const* simplify(formula const*);
+
+        /*Canonical negation of the argument canonical node.*/
+        formula const* negate(formula const*);
+
+        /*Identifier of the argument filter signature (see
+         *\method{BuildFilter::signature()}). Identifiers are never
+         *reused, even once the signature is forgotten.*/
+        unsigned int internFilter(const std::string&);
+
+        /*Assignment of the argument \argument{propositions} to the
+         *atoms of the canonical formula, one bit per atom. The
+         *result is $false$ if the formula has too many atoms for its
+         *traversals to be memoised.*/
+        template<typename Propositions>
+        bool assignment(formula const*,
+                        const Propositions&,
+                        unsigned long long&)const;
+
+        /*Is there a memoised traversal of the canonical formula by a
+         *traverser of the argument type, given the assignment of its
+         *atoms and the identified filter? If so it is written to the
+         *argument \struct{Traversal}.*/
+        bool findTraversal(const std::type_info& traverser,
+                           formula const*,
+                           unsigned long long assignment,
+                           unsigned int filter,
+                           Traversal&)const;
+
+        /*Memoise a traversal (see \method{findTraversal()}).*/
+        void addTraversal(const std::type_info& traverser,
+                          formula const*,
+                          unsigned long long assignment,
+                          unsigned int filter,
+                          const Traversal&);
+
+        /*Number of canonical nodes.*/
+        unsigned int size()const;
+
+        /*Number of memoised traversals.*/
+        unsigned int numberOfTraversals()const;
+    private:
+        /*Nodes are created by the conser visitors, while the table
+         *is locked by \method{intern()}.*/
+        template<class C> friend class PCconser;
+        friend class FLTLconser;
+        friend class PLTLconser;
+
+        /*Identification of a memoised traversal.*/
+        struct TraversalKey
+        {
+            std::type_info const* traverser;
+            formula const* form;
+            unsigned long long assignment;
+            unsigned int filter;
+
+            bool operator<(const TraversalKey&)const;
+        };
+
+        /*What the table knows of each canonical node.*/
+        struct Node
+        {
+            /*The canonical node.*/
+            formula* form;
+
+            /*Hash of the structure of the node, which does not depend
+             *on the order in which nodes are created.*/
+            unsigned long hash;
+
+            /*Index of the atoms of the node in \member{atomLists}.*/
+            unsigned int atoms;
+
+            /*Are the node and all of its subformulae marked negation
+             *normal (see \method{comparable()})?*/
+            bool normal;
+        };
+
+        /*Greatest number of atoms of a formula whose traversals are
+         *memoised (see \method{assignment()}).*/
+        static const unsigned int maximumAtoms = 64;
+
+        /*Greatest number of memoised traversals. The memoised
+         *traversals are forgotten when there are more.*/
+        static const unsigned int maximumTraversals = 1 << 18;
+
+        /*See \method{intern()}, the caller holds the \member{lock}
+         *for writing.*/
+        formula* intern_(formula const*);
+
+        /*Canonical node identified by the argument key, or $0$ if
+         *there is none.*/
+        formula* find(const Key&)const;
+
+        /*Register the argument node under the key. The table takes
+         *ownership of the node whose subformulae must be
+         *canonical.*/
+        formula* insert(const Key&, formula*);
+
+        /*Does the canonical node \argument{left} precede
+         *\argument{right} in the order given to the operands of
+         *commutative connectives? The order is that of the hashes of
+         *the structures of the nodes, and of the order in which the
+         *nodes were created when their hashes are equal.*/
+        bool precedes(formula const* left, formula const* right)const;
+
+        /*Index in \member{atomLists} of the argument sorted list of
+         *literals.*/
+        unsigned int internAtoms(const std::vector<formula const*>&);
+
+        /*Canonical nodes indexed by their identity (see
+         *\method{formula::getNodeId()}). Subformulae are always
+         *created before the formulae they occur in.*/
+        std::vector<Node> nodes;
+
+        /*Canonical nodes indexed by their structure.*/
+        std::map<Key, formula*> index;
+
+        /*Distinct lists of the atoms of canonical nodes. An atom is
+         *a canonical \class{literal}.*/
+        std::vector<std::vector<formula const*> > atomLists;
+
+        /*Index of each of the \member{atomLists}.*/
+        std::map<std::vector<formula const*>, unsigned int> atomListIndex;
+
+        /*Memoised simplifications.*/
+        std::map<formula const*, formula const*> simplifications;
+
+        /*Memoised traversals.*/
+        std::map<TraversalKey, Traversal> traversals;
+
+        /*Interned filter signatures.*/
+        std::map<std::string, unsigned int> filters;
+
+        /*Identifier of the next filter signature interned.*/
+        unsigned int nextFilter;
+
+        /*Lock held for reading by lookups and for writing by any
+         *change to the table.*/
+        mutable pthread_rwlock_t lock;
+
+        /*Ensure that a table cannot be copied.*/
+        FormulaTable(const FormulaTable&);
+        FormulaTable& operator=(const FormulaTable&);
+    };
+
+    /*The argument table is current in the calling thread (see
+     *\method{FormulaTable::getInstance()}) during the life of a
+     *\class{FormulaTableScope}. Scopes nest.*/
+    class FormulaTableScope
+    {
+    public:
+        FormulaTableScope(FormulaTable*);
+
+        ~FormulaTableScope();
+    private:
+        /*Table current before this scope.*/
+        FormulaTable* previous;
+
+        /*Ensure that a scope cannot be copied.*/
+        FormulaTableScope(const FormulaTableScope&);
+        FormulaTableScope& operator=(const FormulaTableScope&);
+    };
+
+    /*Visitor that builds the canonical node of the visited formula in
+     *a \class{FormulaTable}.*/
+    template<class C>
+    class PCconser :
+        public Builder<formula>,
+        public virtual PCvisitor,
+        public C
+    {
+    public:
+        PCconser(FormulaTable* table):table(table){}
+
+        void repass(const formula &c);
+
+        void visit(const conj&);
+        void visit(const disj&);
+        void visit(const literal&);
+        void visit(const assLiteral&);
+        void visit(const iff&);
+        void visit(const imp&);
+        void visit(const lnot&);
+
+        virtual formula* initBuild()
+            {
+                return 0;
+            }
+    protected:
+        /*Table in which nodes are created.*/
+        FormulaTable* table;
+
+        /*Build the canonical node of the argument subformula, which
+         *is immediate if it is canonical already.*/
+        void cons(formula const*);
+
+        /*Build the canonical node of a commutative connective of
+         *type $T$ given the canonical nodes of its operands, which
+         *are put in canonical order.*/
+        template<class T>
+        void consCommutative(formula*, formula*);
+
+        /*Build the canonical node of a connective of type $T$ given
+         *the canonical nodes of its operands.*/
+        template<class T>
+        void consBinary(formula*, formula*);
+
+        /*Build the canonical node of a connective of type $T$ given
+         *the canonical node of its operand.*/
+        template<class T>
+        void consUnary(formula*);
+
+        /*Build the canonical node of a \class{summaryUnary} of type
+         *$T$ given the canonical node of its operand.*/
+        template<class T>
+        void consSummary(formula*, unsigned int depth);
+
+        /*Build the canonical leaf of type $T$ structurally equal to
+         *the argument.*/
+        template<class T>
+        void consLeaf(const formula&);
+    };
+
+    class FLTLconser :
+        public PCconser<FLTLvisitor>
+    {
+    public:
+        FLTLconser(FormulaTable* table):PCconser<FLTLvisitor>(table){}
+
+        void visit(const nxt&);
+        void visit(const fut&);
+        void visit(const strFut&);
+        void visit(const fbx&);
+        void visit(const fdi&);
+        void visit(const dollars&);
+
+        void visit(const nxtDisj&);
+        void visit(const nxtConj&);
+        void visit(const nxtNest&);
+    protected:
+        void accept_(formula const* f)const {FLTLvisitor::accept_(f);}
+    };
+
+    class PLTLconser :
+        public PCconser<PLTLvisitor>
+    {
+    public:
+        PLTLconser(FormulaTable* table):PCconser<PLTLvisitor>(table){}
+
+        void visit(const startStateProposition&);
+        void visit(const prv&);
+        void visit(const snc&);
+        void visit(const pbx&);
+        void visit(const pdi&);
+
+        void visit(const prvConj&);
+        void visit(const prvDisj&);
+        void visit(const prvNest&);
+    protected:
+        void accept_(formula const* f)const {PLTLvisitor::accept_(f);}
+    };
+}
+
+#include"formulaHashConsing_templates.h++"
+
+#endif
@@ -0,0 +1,205 @@
+// Copyright (C) 2002, 2003
+// Charles Gretton and David Price
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#ifndef FORMULA_HASH_CONSING_template
+#define FORMULA_HASH_CONSING_template
+
+namespace Formula
+{
+    /*export*/ template<typename Propositions>
+    bool FormulaTable::assignment(formula const* form,
+                                  const Propositions& propositions,
+                                  unsigned long long& result)const
+    {
+        pthread_rwlock_rdlock(&lock);
+        
+        const std::vector<formula const*>& atoms
+            = atomLists[nodes[form->getNodeId()].atoms];
+        bool memoisable = maximumAtoms >= atoms.size();
+
+        result = 0;
+        for(unsigned int i = 0; memoisable && i != atoms.size(); ++i)
+            if(propositions.end() != propositions.find
+               (static_cast<literal const*>(atoms[i])->getId()))
+                result |= 1ULL << i;
+        
+        pthread_rwlock_unlock(&lock);
+
+        return memoisable;
+    }
+
+    /*export*/ template<class C>
+    void PCconser<C>::repass(const formula &c)
+    {
+        /*The temporal subformula is interned with a visitor suited to
+          its type.*/
+        if(needRepass())
+	    {
+            item = table->intern_(&c);
+	    }
+
+        PCvisitor::repass(c);
+    }
+
+    /*export*/ template<class C>
+    void PCconser<C>::cons(formula const* f)
+    {
+        if(table->isCanonical(f))
+            item = const_cast<formula*>(f);
+        else
+            this->accept_(f);
+    }
+
+    /*export*/ template<class C>
+    template<class T>
+    void PCconser<C>::consCommutative(formula* left, formula* right)
+    {
+        if(table->precedes(right, left))
+            std::swap(left, right);
+
+        consBinary<T>(left, right);
+    }
+
+    /*export*/ template<class C>
+    template<class T>
+    void PCconser<C>::consBinary(formula* left, formula* right)
+    {
+        /*The node is negation normal as its operands are.*/
+        FormulaTable::Key key(typeid(T),
+                              left->isNegNormal() && right->isNegNormal(),
+                              left,
+                              right);
+        
+        if(0 == (item = table->find(key)))
+            item = table->insert(key, new T(left, right));
+    }
+
+    /*export*/ template<class C>
+    template<class T>
+    void PCconser<C>::consUnary(formula* operand)
+    {
+        FormulaTable::Key key(typeid(T), operand->isNegNormal(), operand);
+        
+        if(0 == (item = table->find(key)))
+            item = table->insert(key, new T(operand));
+    }
+
+    /*export*/ template<class C>
+    template<class T>
+    void PCconser<C>::consSummary(formula* operand, unsigned int depth)
+    {
+        FormulaTable::Key key(typeid(T), operand->isNegNormal(), operand, 0, depth);
+        
+        if(0 == (item = table->find(key)))
+            item = table->insert(key, new T(operand, depth));
+    }
+
+    /*export*/ template<class C>
+    template<class T>
+    void PCconser<C>::consLeaf(const formula& f)
+    {
+        FormulaTable::Key key(typeid(T), f.isNegNormal());
+        
+        if(0 == (item = table->find(key)))
+        {
+            item = new T();
+            item->setNegNormal(key.negNormal);
+            item = table->insert(key, item);
+        }
+    }
+
+    /*export*/ template<class C>
+    void PCconser<C>::visit(const literal& l)
+    {
+        FormulaTable::Key key(typeid(literal), true, 0, 0, 0, l.getId());
+        
+        if(0 == (item = table->find(key)))
+            item = table->insert(key, new literal(l));
+    }
+
+    /*export*/ template<class C>
+    void PCconser<C>::visit(const assLiteral& al)
+    {
+        FormulaTable::Key key(typeid(assLiteral), true, 0, 0, al.getAssignment());
+        
+        if(0 == (item = table->find(key)))
+            item = table->insert(key, new assLiteral(al.getAssignment()));
+    }
+
+    /*export*/ template<class C>
+    void PCconser<C>::visit(const conj& f)
+    {
+        formula* tmp;
+        cons(f[0]);
+        tmp = item;
+        cons(f[1]);
+        
+        consCommutative<conj>(tmp, item);
+    }
+
+    /*export*/ template<class C>
+    void PCconser<C>::visit(const disj& f)
+    {
+        formula* tmp;
+        cons(f[0]);
+        tmp = item;
+        cons(f[1]);
+        
+        consCommutative<disj>(tmp, item);
+    }
+
+    /*export*/ template<class C>
+    void PCconser<C>::visit(const iff& f)
+    {
+        formula* tmp;
+        cons(f[0]);
+        tmp = item;
+        cons(f[1]);
+        
+        consCommutative<iff>(tmp, item);
+    }
+
+    /*export*/ template<class C>
+    void PCconser<C>::visit(const imp& f)
+    {
+        formula* tmp;
+        cons(f[0]);
+        tmp = item;
+        cons(f[1]);
+        
+        consBinary<imp>(tmp, item);
+    }
+
+    /*export*/ template<class C>
+    void PCconser<C>::visit(const lnot& f)
+    {
+        cons(f[0]);
+
+        /*A negation is not marked negation normal on construction,
+          thus the mark of the visited negation is kept.*/
+        FormulaTable::Key key(typeid(lnot), f.isNegNormal(), item);
+        
+        if(0 == (item = table->find(key)))
+        {
+            item = new lnot(item);
+            item->setNegNormal(key.negNormal);
+            item = table->insert(key, item);
+        }
+    }
+}
+
+#endif
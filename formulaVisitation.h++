@@ -66,6 +66,7 @@
 #include"formulaTypes.h++"
 #include<cassert>
 #include<iostream>
+#include<string>
 
 namespace Formula
 {          
@@ -81,6 +82,13 @@ namespace Formula
         /*Apply the filter. Some filters only act minimally, ie: when they
          *are given their \argument{lastChance}.*/
         virtual T* operator()(T*, bool lastChance = false)const = 0;
+
+        /*Filters whose behaviour is determined by a string describe
+         *themselves in the argument and return $true$. Traversals
+         *built with such a filter may be memoised (see
+         *\class{FormulaTable}). By default a filter can not be
+         *described.*/
+        virtual bool signature(std::string&)const{return false;}
     };
 
     /*A filter that does nothing.*/
@@ -89,6 +97,8 @@ namespace Formula
     {
     public:
         T* operator()(T* t, bool lastChance)const{return t;}
+
+        bool signature(std::string& sig)const{sig = "null"; return true;}
     };
     
     /*Visitation builder that builds an item by traversal shall be a
@@ -51,6 +51,7 @@
 #include"AutomaticConstraintGeneratorWrapper.h++"
 #include"StructuredSolutionWrapper.h++"
 #include"StateBasedSolutionWrapper.h++"
+#include"WorkerPool.h++"
 
 using namespace MDP;
 
@@ -103,6 +104,7 @@ int main(int argc, char **argv)
 
     CommandInterpreter::destroyInstance();
     Registry::destroyInstance();
+    WorkerPool::destroyInstance();
 
     return 0;
 }
@@ -33,8 +33,13 @@ using namespace std;
 
 bool RewardSpecification::FSpec::operator==(const FSpec& fSpec)const
 {
-    return ((*form) == *fSpec.form)
-        && (value == fSpec.value);
+    if(value != fSpec.value)
+        return false;
+
+    if(FormulaTable::comparable(form, fSpec.form))
+        return form == fSpec.form;
+    
+    return (*form) == *fSpec.form;
 }  
 
 /*******************************************************ContainedFormulaEqual*/
@@ -43,6 +48,9 @@ bool RewardSpecification::ContainedFormulaEqual::operator()
     (const RewardSpecification::SpecificationContainer::value_type& rSpec,
      const vector<formula const*>& f) const
 {
+    if(FormulaTable::comparable(f[0], rSpec.second.form))
+        return f[0] == rSpec.second.form;
+    
     return (*f[0]) == *rSpec.second.form;
 }
     
@@ -62,6 +70,13 @@ const string RewardSpecification::RewardAbnormality::getMessage()const
 
 /*******************************************************RewardSpecification*/
 
+void RewardSpecification::releaseFormula(formula* form)
+{
+    /*Canonical nodes are freed with their table.*/
+    if(0 != form && 0 == form->getTable())
+        delete form;
+}
+
 RewardSpecification::RewardSpecification()
     :expansionRequired(true),
      rewardCache(0)
@@ -74,13 +89,15 @@ RewardSpecification::RewardSpecification(const RewardSpecification& rewardSpecif
 
     specificationContents = rewardSpecification.specificationContents;
     
-    /*Make copies of the argument specification formulae*/
+    /*Make copies of the argument specification formulae, canonical
+      formulae are immutable and shared.*/
     for(rIterator p = specificationContents.begin()
 	    ; p != specificationContents.end()
 	    ; ++p)
 	{
-	    p->second.form =
-            p->second.form->copy();
+        if(0 == p->second.form->getTable())
+            p->second.form =
+                p->second.form->copy();
 	}
 }
 
@@ -93,7 +110,7 @@ RewardSpecification::~RewardSpecification()
 	    ; p != specificationContents.end()
 	    ; ++p)
 	{
-	    delete  p->second.form;
+	    releaseFormula(p->second.form);
 	}
 }
 
@@ -120,7 +137,7 @@ RewardSpecification* RewardSpecification::addSpecComponent(string label, double
 	    /*$tmp_$ shall be $0$ if no expansion was possible.*/
 	    if(0 != tmp_ && !tmp_->typeExpansionPossible())
         {
-            delete form;/*We don't require this formula anymore*/
+            releaseFormula(form);/*We don't require this formula anymore*/
             return tmp_;/*as we are going to use the expansion.*/
         }
         else if(0 != tmp_)/*If we aren't going to use the expansion
@@ -137,7 +154,7 @@ RewardSpecification* RewardSpecification::addSpecComponent(string label, double
       added to the \member{specificationContents} then it is deleted
       before replacement.*/
     if(specificationContents.end() != specificationContents.find(label))
-        delete specificationContents[label].form;
+        releaseFormula(specificationContents[label].form);
     
     specificationContents[label]=fSpec;
 
@@ -264,7 +281,7 @@ void RewardSpecification::normalise()
             throw;
         }
         
-	    delete p->second.form;
+	    releaseFormula(p->second.form);
 	    p->second.form = tmp;
 	}
 }
@@ -278,7 +295,7 @@ void RewardSpecification::simplify()
 	    ; ++p)
 	{
 	    formula *tmp = (p->second.form)->simplify();
-	    delete p->second.form;
+	    releaseFormula(p->second.form);
 	    p->second.form = tmp;
 	}
 }
@@ -377,6 +394,20 @@ unsigned int RewardSpecification::memory()const
     return size;
 }
 
+unsigned long long RewardSpecification::heapMemory()const
+{
+    unsigned long long size = 0;
+
+    for(crIterator p = specificationContents.begin()
+            ; p != specificationContents.end()
+            ; ++p)
+        size += DomainSpecification::treeNodeOverhead
+            + sizeof(*p)
+            + p->first.size() * sizeof(char);
+
+    return size;
+}
+
 RewardCalculator* RewardSpecification::getRewardCalculator()const
 {
     return new PLTLrewardCalculator;
@@ -26,6 +26,7 @@
 
 #include"formula.h++"
 #include"formulaTreeCast.h++"
+#include"formulaHashConsing.h++"
 
 #include"RewardCalculation.h++"
 #include"domainSpecification.h++"
@@ -42,6 +43,11 @@ namespace MDP
     class RewardSpecification
     {
     public:
+        /*Specifications are allocated from the current
+         *\class{Arena}, as are their formulae.*/
+        static void* operator new(size_t size){return Arena::allocate(size);}
+        static void operator delete(void* specification){Arena::deallocate(specification);}
+
         /*Storage type for reward formula and their associated
          *values. The structure can be be seen as a \class{formula}
          *\class{value/double} pair endowed with an equality test.*/
@@ -50,7 +56,9 @@ namespace MDP
             formula *form;
             double value;
             
-            /*Equality is solely that of the members.*/
+            /*Equality is solely that of the members. Canonical
+             *formulae are compared by address where that decides
+             *their equality (see \method{FormulaTable::comparable()}).*/
             bool operator==(const FSpec& fSpec)const;
         };
 
@@ -115,6 +123,10 @@ namespace MDP
         virtual double sequenceTraversal(const DomainSpecification::PropositionSet&,
                                          const BuildFilter<formula>& = NullFilter<formula>());
         
+        /*Free the argument specification formula, unless it is a
+         *canonical node shared through a \class{FormulaTable}.*/
+        static void releaseFormula(formula*);
+
         /*Reward specification construction provides the following
          *assumptions:
          *
@@ -129,7 +141,8 @@ namespace MDP
         RewardSpecification();
 
         /*Generate a reward specification from the argument
-         *specification.*/
+         *specification. Canonical formulae are shared, others are
+         *copied.*/
         RewardSpecification(const RewardSpecification&);
 
         /*Free resources taken by the free store formulae.*/
@@ -227,6 +240,11 @@ namespace MDP
         /*Approximatly the amount of memory taken by this
          *specification. The result is a number of Kb.*/
         virtual unsigned int memory()const;
+
+        /*Approximately the number of bytes of the nodes of the
+         *\member{specificationContents} and of their labels. These
+         *are kept on the heap whichever \class{Arena} is current.*/
+        unsigned long long heapMemory()const;
         
         /*Obtain a reward calculator suitable for calculating the
          *reward associated with an \class{eState} labelled with this
@@ -30,29 +30,86 @@ namespace MDP
     
         /*Total reward obtained by sequence traversal.*/
         double totalReward = 0.0;
-	
-        /*Configure the traverser with state characterising
-          propositions.*/
-        traverser.setPropositionContainer(&propositions);
 
-        /*Configure the building filter for traversal.*/
-        traverser.setBuildFilter(&buildFilter);
+        /*The traverser is configured when a formula is first
+          traversed, memoised traversals do not require it.*/
+        bool configured = false;
+
+        /*Traversals are memoised against the canonical formula, the
+          assignment of the propositions to its atoms and the filter,
+          which is only possible if the filter can describe itself
+          and a \class{FormulaTable} is current.*/
+        FormulaTable* formulaTable = FormulaTable::getInstance();
+        string filterSignature;
+        bool canonise = 0 != formulaTable;
+        bool memoise = canonise && buildFilter.signature(filterSignature);
+        unsigned int filterKey = 0;
+        
+        if(memoise)
+            filterKey = formulaTable->internFilter(filterSignature);
             
         /*Traverse all specification reward formulae.*/
         for(RewardSpecification::rIterator p = begin()
                 ; p != end()
                 ; ++p)
-	    {  
+	    {
+            formula const* canonical = 0;
+            unsigned long long assignment = 0;
+            bool memoised = false;
+            FormulaTable::Traversal traversal;
+            
+            if(memoise)
+            {
+                /*Immediate where the formula is shared already.*/
+                canonical = formulaTable->intern(p->second.form);
+
+                memoised = formulaTable->assignment(canonical,
+                                                    propositions,
+                                                    assignment);
+
+                /*If this formula has been traversed given the same
+                  assignment of its atoms before.*/
+                if(memoised
+                   && formulaTable->findTraversal(typeid(Traverser),
+                                                  canonical,
+                                                  assignment,
+                                                  filterKey,
+                                                  traversal))
+                {
+                    totalReward += getReward(traversal.rewarding,
+                                             p,
+                                             const_cast<formula*>(traversal.build));
+                    
+                    releaseFormula(p->second.form);
+                    p->second.form = const_cast<formula*>(traversal.simplified);
+                    continue;
+                }
+            }
+
+            if(!configured)
+            {
+                /*Configure the traverser with state characterising
+                  propositions.*/
+                traverser.setPropositionContainer(&propositions);
+
+                /*Configure the building filter for traversal.*/
+                traverser.setBuildFilter(&buildFilter);
+
+                configured = true;
+            }
+            
             traverser.initBuild();
             (p->second.form)->accept(&traverser);/*Traverse the formula*/
-		
+
+            bool rewarding;
+            
             try{/*Reward establishment may lead to exceptional
                   circumstances if the rewards specified were
                   abnormal.*/
 
                 /*Reward established through traversal can change
                   after rewardability has been checked.*/
-                bool rewarding = traverser.rewarding();
+                rewarding = traverser.rewarding();
                 
                 totalReward += getReward(rewarding, 
                                          p, 
@@ -63,8 +120,26 @@ namespace MDP
                 throw;
             }
             
-            delete p->second.form;
-            p->second.form = traverser.getBuild()->simplify();/*Simplify the result of traversal*/
+            releaseFormula(p->second.form);
+
+            if(canonise)
+            {
+                /*The simplified result is shared.*/
+                traversal.rewarding = rewarding;
+                traversal.build = formulaTable->intern(traverser.getBuild());
+                traversal.simplified = formulaTable->simplify(traversal.build);
+
+                if(memoised)
+                    formulaTable->addTraversal(typeid(Traverser),
+                                               canonical,
+                                               assignment,
+                                               filterKey,
+                                               traversal);
+                
+                p->second.form = const_cast<formula*>(traversal.simplified);
+            }
+            else
+                p->second.form = traverser.getBuild()->simplify();/*Simplify the result of traversal*/
             
             delete traverser.getBuild();
 	    }